@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/TrainManager.h"
+#include "../src/NetworkSnapshot.h"
+#include "../src/NetworkGenerator.h"
+#include "../data_structures/Instrumentation.h"
+using namespace std;
+
+/*
+ * Benchmarks of the loaders, the flow algorithms and the reports, on the network in the resources directory and on
+ * synthetic networks. Every benchmark is repeated after a few warm-up runs and its percentiles are printed, and
+ * optionally written as JSON to compare builds, with the average counters of a run when the build has
+ * instrumentation:
+ *
+ *   bench [--resources DIR] [--synthetic STATIONS]... [--warmup N] [--runs N] [--max-seconds S] [--threads N]
+ *         [--seed N] [--json FILE]
+ */
+
+namespace {
+    struct Options {
+        string resources = "../resources";
+        vector<int> synthetic;
+        int warmup = 3;
+        int runs = 30;
+        double maxSeconds = 2;      // a benchmark stops after this time, once it has at least 3 runs
+        unsigned int threads = 0;
+        unsigned long long seed = 1;
+        string json;
+    };
+
+    struct Measurement {
+        vector<double> times;       // microseconds, sorted
+        int runs = 0;               // including the warm-up runs
+        Instrumentation::Totals counters;   // counted during every run, warm-up included
+    };
+
+    struct Result {
+        string dataset;
+        int stations;
+        int segments;
+        string benchmark;
+        Measurement measurement;
+    };
+
+    /**
+     * @return The p-th percentile of sorted times, by the nearest rank method
+     */
+    double percentile(const vector<double>& times, double p) {
+        size_t rank = (size_t) ceil(p / 100 * times.size());
+        return times[min(times.size(), max<size_t>(rank, 1)) - 1];
+    }
+
+    double mean(const vector<double>& times) {
+        double sum = 0;
+        for (double t : times) sum += t;
+        return sum / times.size();
+    }
+
+    /**
+     * Times body(i) for every run i, after calling setup(i), which is not timed. The warm-up runs come first and
+     * are not recorded.
+     * @return The duration of every recorded run in microseconds, sorted, and what was counted
+     */
+    Measurement measure(const Options& options, const function<void(int)>& setup,
+                        const function<void(int)>& body) {
+        Measurement res;
+        vector<double>& times = res.times;
+        Instrumentation::Totals before = Instrumentation::snapshot();
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < options.warmup + options.runs; i++) {
+            res.runs++;
+            setup(i);
+            auto before = chrono::steady_clock::now();
+            body(i);
+            auto after = chrono::steady_clock::now();
+            if (i < options.warmup) continue;
+            times.push_back(chrono::duration<double, micro>(after - before).count());
+            if (times.size() >= 3 && chrono::duration<double>(after - start).count() > options.maxSeconds) break;
+        }
+        sort(times.begin(), times.end());
+        res.counters = Instrumentation::snapshot() - before;
+        return res;
+    }
+
+    class Suite {
+    public:
+        explicit Suite(const Options& options) : options(options), driver(options.threads) {}
+
+        /**
+         * Runs every benchmark on the network of two CSV files.
+         */
+        void run(const string& dataset, const string& stationsFile, const string& networkFile) {
+            auto manager = make_unique<TrainManager>(stationsFile, networkFile);
+            manager->LoadStations();
+            manager->LoadNetworks();
+            CSRGraph network(manager->getNetwork());
+            stations = network.getNumVertex();
+            segments = network.getNumArcs() / 2;
+            this->dataset = dataset;
+            cout << dataset << ": " << stations << " stations, " << segments << " segments\n";
+
+            unique_ptr<TrainManager> fresh;
+            auto newManager = [&](int){ fresh = make_unique<TrainManager>(stationsFile, networkFile); };
+            add("load_stations", measure(options, newManager, [&](int){ fresh->LoadStations(); }));
+            add("load_networks", measure(options, [&](int i){ newManager(i); fresh->LoadStations(); },
+                                         [&](int){ fresh->LoadNetworks(); }));
+            string snapshotFile = networkFile + ".snapshot";
+            NetworkSnapshot::write(snapshotFile, manager->getNetwork(), {stationsFile, networkFile});
+            add("load_snapshot", measure(options, newManager, [&](int){ fresh->LoadSnapshot(snapshotFile); }));
+            fresh.reset();
+            filesystem::remove(snapshotFile);
+            add("csr_build", measure(options, [](int){}, [&](int){ CSRGraph copy(manager->getNetwork()); }));
+
+            // the same pairs of stations on the same line, so that there is a flow between them, for every build
+            vector<pair<int,int>> pairs = pickPairs(network);
+            if (pairs.empty()) return;
+            FlowWorkspace ws;
+            unsigned long checksum = 0;
+            auto query = [&](int i){ return pairs[i % pairs.size()]; };
+            const pair_engine engines[] = {{"edmonds_karp", FlowEngine::EDMONDS_KARP}, {"dinic", FlowEngine::DINIC},
+                                           {"push_relabel", FlowEngine::PUSH_RELABEL}};
+            for (auto& e : engines) {
+                add(e.first, measure(options, [](int){}, [&](int i){
+                    checksum += network.maxFlow(ws, query(i).first, query(i).second, e.second);
+                }));
+            }
+            add("max_flow_after_prim", measure(options, [](int){}, [&](int i){
+                checksum += network.maxFlowAfterPrim(ws, query(i).first, query(i).second);
+            }));
+            add("min_cost_max_flow", measure(options, [](int){}, [&](int i){
+                checksum += network.minCostMaxFlow(ws, query(i).first, query(i).second).cost;
+            }));
+
+            unique_ptr<InflowSourceTable> sources;
+            add("inflow_sources", measure(options, [](int){}, [&](int){
+                sources = make_unique<InflowSourceTable>(network, driver);
+            }));
+            vector<int> leaves;
+            add("inflow", measure(options, [](int){}, [&](int i){
+                int t = query(i).second;
+                sources->get(t, leaves);
+                if (!leaves.empty()) checksum += network.maxFlow(ws, leaves, t, FlowEngine::EDMONDS_KARP);
+            }));
+
+            add("all_pairs", measure(options, [](int){}, [&](int){
+                GomoryHuTree tree(network, FlowEngine::DINIC, driver);
+                PairFlowMatrix flows(network, tree, driver);
+                checksum += flows.get(pairs[0].first, pairs[0].second);
+            }));
+
+            // the segments leaving the first stations of the pairs fail one at a time
+            vector<FailureScenarioEngine::Scenario> scenarios;
+            for (size_t i = 0; i < pairs.size() && scenarios.size() < 8; i++) {
+                int s = pairs[i].first;
+                for (int t : {s - 1, s + 1}) {
+                    if (t >= 0 && t < stations && network.findArc(s, t) != -1) {
+                        scenarios.push_back({{s, t}});
+                        break;
+                    }
+                }
+            }
+            if (!scenarios.empty()) {
+                add("failure_scenarios", measure(options, [](int){}, [&](int){
+                    auto impacts = FailureScenarioEngine(network, driver).evaluate(scenarios);
+                    checksum += impacts[0].size();
+                }));
+            }
+            // printed so that the queries cannot be optimized away, and to check that builds agree
+            cout << "checksum " << checksum << "\n\n";
+        }
+
+        void print() const {
+            cout << left << setw(16) << "Dataset" << setw(22) << "Benchmark" << right << setw(6) << "Runs"
+                 << setw(13) << "Mean (us)" << setw(13) << "p50" << setw(13) << "p90" << setw(13) << "p99"
+                 << setw(13) << "Max" << '\n';
+            for (const Result& r : results) {
+                const vector<double>& times = r.measurement.times;
+                cout << left << setw(16) << r.dataset << setw(22) << r.benchmark << right << setw(6)
+                     << times.size() << fixed << setprecision(2) << setw(13) << mean(times) << setw(13)
+                     << percentile(times, 50) << setw(13) << percentile(times, 90) << setw(13)
+                     << percentile(times, 99) << setw(13) << times.back() << '\n';
+            }
+        }
+
+        void writeJson(ostream& out) const {
+            out << "{\n  \"warmup\": " << options.warmup << ",\n  \"runs\": " << options.runs
+                << ",\n  \"threads\": " << driver.getNumThreads() << ",\n  \"seed\": " << options.seed
+                << ",\n  \"results\": [";
+            for (size_t i = 0; i < results.size(); i++) {
+                const Result& r = results[i];
+                const vector<double>& times = r.measurement.times;
+                out << (i == 0 ? "\n" : ",\n") << fixed << setprecision(3)
+                    << "    {\"dataset\": \"" << r.dataset << "\", \"stations\": " << r.stations
+                    << ", \"segments\": " << r.segments << ", \"benchmark\": \"" << r.benchmark
+                    << "\", \"runs\": " << times.size() << ", \"mean_us\": " << mean(times)
+                    << ", \"min_us\": " << times.front() << ", \"p50_us\": " << percentile(times, 50)
+                    << ", \"p90_us\": " << percentile(times, 90) << ", \"p99_us\": " << percentile(times, 99)
+                    << ", \"max_us\": " << times.back();
+                if (Instrumentation::enabled) {
+                    out << ", \"counters_per_run\": ";
+                    Instrumentation::writeJson(out, r.measurement.counters, r.measurement.runs);
+                }
+                out << "}";
+            }
+            out << "\n  ]\n}\n";
+        }
+
+    private:
+        using pair_engine = pair<const char*, FlowEngine>;
+
+        void add(const string& benchmark, Measurement measurement) {
+            results.push_back({dataset, stations, segments, benchmark, move(measurement)});
+        }
+
+        /**
+         * @return Up to 64 pairs of distinct stations on the same line and in the same component, chosen from the
+         * seed
+         */
+        vector<pair<int,int>> pickPairs(const CSRGraph& network) const {
+            mt19937_64 rng(options.seed);
+            vector<pair<int,int>> pairs;
+            int n = network.getNumVertex();
+            for (int attempt = 0; attempt < 64 * 64 && pairs.size() < 64 && n > 1; attempt++) {
+                int s = (int) (rng() % n), t = (int) (rng() % n);
+                if (s != t && network.getLine(s) == network.getLine(t) &&
+                    network.getComponent(s) == network.getComponent(t)) {
+                    pairs.emplace_back(s, t);
+                }
+            }
+            return pairs;
+        }
+
+        const Options& options;
+        ParallelFlowDriver driver;
+        vector<Result> results;
+        string dataset;
+        int stations = 0;
+        int segments = 0;
+    };
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            string value = argv[++i];
+            try {
+                if (arg == "--resources") options.resources = value;
+                else if (arg == "--synthetic") options.synthetic.push_back(stoi(value));
+                else if (arg == "--warmup") options.warmup = stoi(value);
+                else if (arg == "--runs") options.runs = stoi(value);
+                else if (arg == "--max-seconds") options.maxSeconds = stod(value);
+                else if (arg == "--threads") options.threads = stoul(value);
+                else if (arg == "--seed") options.seed = stoull(value);
+                else if (arg == "--json") options.json = value;
+                else return false;
+            }
+            catch (const logic_error&) {
+                return false;
+            }
+        }
+        return options.warmup >= 0 && options.runs > 0 &&
+               all_of(options.synthetic.begin(), options.synthetic.end(), [](int n){ return n > 1; });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "Usage: bench [--resources DIR] [--synthetic STATIONS]... [--warmup N] [--runs N] "
+                "[--max-seconds S] [--threads N] [--seed N] [--json FILE]\n";
+        return 1;
+    }
+    if (options.synthetic.empty()) options.synthetic.push_back(2000);
+
+    Suite suite(options);
+    suite.run("resources", options.resources + "/stations.csv", options.resources + "/network.csv");
+    for (int n : options.synthetic) {
+        string dir = filesystem::temp_directory_path().string();
+        string prefix = dir + "/bench-synthetic-" + to_string(n) + "-" + to_string(options.seed);
+        NetworkGenerator::Parameters parameters;
+        parameters.stations = n;
+        parameters.lines = max(1, n / 100);
+        parameters.seed = options.seed;
+        if (NetworkGenerator(parameters).write(prefix + "-stations.csv", prefix + "-network.csv") < 0) {
+            cerr << "Could not write the synthetic network to " << dir << "!\n";
+            return 1;
+        }
+        suite.run("synthetic-" + to_string(n), prefix + "-stations.csv", prefix + "-network.csv");
+        filesystem::remove(prefix + "-stations.csv");
+        filesystem::remove(prefix + "-network.csv");
+    }
+
+    suite.print();
+    if (options.json == "-") suite.writeJson(cout);
+    else if (!options.json.empty()) {
+        ofstream out(options.json);
+        suite.writeJson(out);
+        if (!out) {
+            cerr << "Could not write " << options.json << "!\n";
+            return 1;
+        }
+    }
+    return 0;
+}
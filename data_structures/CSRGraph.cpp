@@ -0,0 +1,794 @@
+#include <climits>
+#include <cstdlib>
+#include "CSRGraph.h"
+#include "Instrumentation.h"
+
+CSRGraph::CSRGraph(const Graph &g) {
+    vertices = g.getVertexSet();
+    int n = vertices.size();
+    index.reserve(n);
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
+    }
+
+    line.resize(n);
+    for (int i = 0; i < n; i++) {
+        line[i] = vertices[i]->getStation().getLineId();
+    }
+
+    // every edge takes one arc at its origin, edges without reverse also need a residual arc at their destination
+    offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        for (Edge* e : vertices[i]->getAdj()) {
+            offsets[i + 1]++;
+            if (e->getReverse() == nullptr) offsets[index[e->getDest()] + 1]++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    int m = offsets[n];
+    targets.resize(m);
+    capacity.resize(m);
+    reverse.resize(m);
+    real.resize(m);
+    service.resize(m);
+    cost.resize(m);
+
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    std::unordered_map<const Edge*, int> arcOf;
+    for (int i = 0; i < n; i++) {
+        for (Edge* e : vertices[i]->getAdj()) {
+            int a = next[i]++;
+            arcOf[e] = a;
+            targets[a] = index[e->getDest()];
+            capacity[a] = e->getWeight();
+            real[a] = true;
+            service[a] = e->getServiceId();
+            cost[a] = Service::getCost(service[a]);
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        for (Edge* e : vertices[i]->getAdj()) {
+            int a = arcOf[e];
+            if (e->getReverse() != nullptr) {
+                reverse[a] = arcOf[e->getReverse()];
+                continue;
+            }
+            int r = next[targets[a]]++;
+            targets[r] = i;
+            capacity[r] = 0;
+            real[r] = false;
+            service[r] = Service::STANDARD;
+            cost[r] = 0;
+            reverse[a] = r;
+            reverse[r] = a;
+        }
+    }
+    buildComponents();
+}
+
+void CSRGraph::buildComponents() {
+    int n = getNumVertex();
+    component.assign(n, -1);
+    componentMembers.clear();
+    componentMembers.reserve(n);
+    componentOffsets.assign(1, 0);
+    for (int i = 0; i < n; i++) {
+        if (component[i] != -1) continue;
+        int c = componentOffsets.size() - 1;
+        component[i] = c;
+        // the members found so far are also the stack of the search
+        size_t next = componentMembers.size();
+        componentMembers.push_back(i);
+        while (next < componentMembers.size()) {
+            int v = componentMembers[next++];
+            for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+                if (component[targets[a]] == -1) {
+                    component[targets[a]] = c;
+                    componentMembers.push_back(targets[a]);
+                }
+            }
+        }
+        componentOffsets.push_back(componentMembers.size());
+    }
+}
+
+int CSRGraph::getNumVertex() const {
+    return vertices.size();
+}
+
+int CSRGraph::getNumArcs() const {
+    return targets.size();
+}
+
+int CSRGraph::indexOf(const Vertex *v) const {
+    auto it = index.find(v);
+    if (it == index.end()) return -1;
+    return it->second;
+}
+
+Vertex *CSRGraph::getVertex(int i) const {
+    return vertices[i];
+}
+
+int CSRGraph::getLine(int i) const {
+    return line[i];
+}
+
+int CSRGraph::tail(int a) const {
+    return targets[reverse[a]];
+}
+
+int CSRGraph::findArc(int s, int t) const {
+    for (int a = offsets[s]; a < offsets[s + 1]; a++) {
+        if (targets[a] == t && real[a]) return a;
+    }
+    return -1;
+}
+
+std::vector<int> CSRGraph::distinctSources(const std::vector<int> &sources, int t) const {
+    std::vector<int> valid;
+    for (int s : sources) {
+        if (s != t && component[s] == component[t]) valid.push_back(s);
+    }
+    std::sort(valid.begin(), valid.end());
+    valid.erase(std::unique(valid.begin(), valid.end()), valid.end());
+    return valid;
+}
+
+bool CSRGraph::findAugmentingPath(FlowWorkspace& ws, const std::vector<int>& sources, int t,
+                                  const std::vector<int>& cap) const {
+    ws.clearVisited();
+    int head = 0, size = 0;
+    for (int s : sources) {
+        ws.setVisited(s);
+        ws.parent[s] = -1;
+        ws.queue[size++] = s;
+    }
+    long scanned = 0;
+    while (head < size && !ws.isVisited(t)) {
+        int v = ws.queue[head++];
+        scanned += offsets[v + 1] - offsets[v];
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+            int w = targets[a];
+            if (!ws.isVisited(w) && cap[a] - ws.flow[a] > 0) {
+                ws.setVisited(w);
+                ws.parent[w] = a;
+                ws.queue[size++] = w;
+            }
+        }
+    }
+    COUNT_EVENTS(BFS_RUNS, 1);
+    COUNT_EVENTS(BFS_VERTICES, head);
+    COUNT_EVENTS(BFS_ARCS, scanned);
+    return ws.isVisited(t);
+}
+
+int CSRGraph::findMinResidualAlongPath(const FlowWorkspace& ws, int t, const std::vector<int>& cap) const {
+    int f = INT_MAX;
+    for (int v = t; ws.parent[v] != -1; v = tail(ws.parent[v])) {
+        int a = ws.parent[v];
+        f = std::min(f, cap[a] - ws.flow[a]);
+    }
+    return f;
+}
+
+void CSRGraph::augmentFlowAlongPath(FlowWorkspace& ws, int t, int f) const {
+    long length = 0;
+    for (int v = t; ws.parent[v] != -1; v = tail(ws.parent[v])) {
+        int a = ws.parent[v];
+        ws.flow[a] += f;
+        ws.flow[reverse[a]] -= f;
+        length++;
+    }
+    COUNT_EVENTS(AUGMENTATIONS, 1);
+    COUNT_EVENTS(AUGMENTED_ARCS, length);
+}
+
+unsigned long CSRGraph::maxFlow(FlowWorkspace& ws, int s, int t, FlowEngine engine) const {
+    if (line[s] != line[t] || component[s] != component[t]) return 0;
+    return maxFlow(ws, std::vector<int>{s}, t, engine);
+}
+
+unsigned long CSRGraph::maxFlow(FlowWorkspace& ws, const std::vector<int>& sources, int t, FlowEngine engine) const {
+    std::vector<int> valid = distinctSources(sources, t);
+    if (valid.empty()) return 0;
+    switch (engine) {
+        case FlowEngine::DINIC: return dinic(ws, valid, t);
+        case FlowEngine::PUSH_RELABEL: return pushRelabel(ws, valid, t);
+        default: return edmondsKarp(ws, valid, t);
+    }
+}
+
+unsigned int CSRGraph::edmondsKarp(FlowWorkspace& ws, int s, int t) const {
+    if (line[s] != line[t] || component[s] != component[t] || s == t) return 0;
+    return edmondsKarp(ws, std::vector<int>{s}, t);
+}
+
+unsigned long CSRGraph::edmondsKarp(FlowWorkspace& ws, const std::vector<int>& sources, int t) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    resetFlow(ws, t);
+
+    // Loop to find augmentation paths
+    unsigned long max_flow = 0;
+    while (findAugmentingPath(ws, sources, t, capacity)) {
+        int f = findMinResidualAlongPath(ws, t, capacity);
+        augmentFlowAlongPath(ws, t, f);
+        max_flow += f;
+    }
+    return max_flow;
+}
+
+void CSRGraph::resetFlow(FlowWorkspace &ws, int t) const {
+    int c = component[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        int v = componentMembers[i];
+        std::fill(ws.flow.begin() + offsets[v], ws.flow.begin() + offsets[v + 1], 0);
+    }
+}
+
+unsigned long CSRGraph::startIncrementalFlow(FlowWorkspace &ws, const std::vector<int> &sources, int t) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    std::fill(ws.flow.begin(), ws.flow.end(), 0);
+    ws.incrementalCapacity = capacity;
+    ws.removedArc.assign(getNumArcs(), false);
+    ws.incrementalSource.assign(getNumVertex(), false);
+    ws.incrementalSources = distinctSources(sources, t);
+    for (int s : ws.incrementalSources) {
+        ws.incrementalSource[s] = true;
+    }
+    ws.incrementalTarget = t;
+    return augmentIncrementalFlow(ws);
+}
+
+unsigned long CSRGraph::removeSegment(FlowWorkspace &ws, int a) const {
+    ws.removedArc[a] = true;
+    ws.removedArc[reverse[a]] = real[reverse[a]];
+    return setSegmentCapacity(ws, a, 0);
+}
+
+unsigned long CSRGraph::restoreSegment(FlowWorkspace &ws, int a) const {
+    for (int b : {a, reverse[a]}) {
+        if (!real[b]) continue;
+        ws.removedArc[b] = false;
+        changeCapacity(ws, b, capacity[b]);
+    }
+    return augmentIncrementalFlow(ws);
+}
+
+unsigned long CSRGraph::setSegmentCapacity(FlowWorkspace &ws, int a, int c) const {
+    changeCapacity(ws, a, c);
+    if (real[reverse[a]]) changeCapacity(ws, reverse[a], c);
+    return augmentIncrementalFlow(ws);
+}
+
+unsigned long CSRGraph::setIncrementalSources(FlowWorkspace &ws, const std::vector<int> &sources) const {
+    std::vector<int> previous = std::move(ws.incrementalSources);
+    ws.incrementalSources = distinctSources(sources, ws.incrementalTarget);
+    for (int s : ws.incrementalSources) {
+        ws.incrementalSource[s] = true;
+    }
+
+    // the dropped sources must no longer send or receive flow; they stay sources until their flow is cancelled, so
+    // that every other vertex keeps receiving as much as it sends and the paths to cancel always exist
+    bool balanced = true;
+    for (int s : previous) {
+        if (std::binary_search(ws.incrementalSources.begin(), ws.incrementalSources.end(), s)) continue;
+        balanced = balanced && cancelNetFlow(ws, s);
+        ws.incrementalSource[s] = false;
+    }
+    if (!balanced) {
+        // the flow is no longer valid, it is computed again from scratch
+        std::fill(ws.flow.begin(), ws.flow.end(), 0);
+    }
+    return augmentIncrementalFlow(ws);
+}
+
+bool CSRGraph::cancelNetFlow(FlowWorkspace &ws, int v) const {
+    // flow leaving v, the arcs whose reverse brings flow to v having a negative flow
+    long long net = 0;
+    for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+        net += ws.flow[a];
+    }
+    int end;
+    while (net != 0) {
+        int f = cancelFlowPath(ws, v, (int) std::min<long long>(std::abs(net), INT_MAX), net < 0, -1, end);
+        if (f == 0) return false;
+        net += net < 0 ? f : -f;
+    }
+    return true;
+}
+
+unsigned long CSRGraph::augmentIncrementalFlow(FlowWorkspace &ws) const {
+    int t = ws.incrementalTarget;
+    while (findAugmentingPath(ws, ws.incrementalSources, t, ws.incrementalCapacity)) {
+        int f = findMinResidualAlongPath(ws, t, ws.incrementalCapacity);
+        augmentFlowAlongPath(ws, t, f);
+    }
+    // every arc into t is the reverse of an arc out of t
+    long long inflow = 0;
+    for (int a = offsets[t]; a < offsets[t + 1]; a++) {
+        inflow -= ws.flow[a];
+    }
+    return inflow;
+}
+
+void CSRGraph::changeCapacity(FlowWorkspace &ws, int a, int c) const {
+    ws.incrementalCapacity[a] = c;
+    int excess = ws.flow[a] - c;
+    if (excess <= 0) return;
+    ws.flow[a] -= excess;
+    ws.flow[reverse[a]] += excess;
+
+    // now u receives more flow than it sends and v sends more than it receives, unless they are sources or the target
+    int u = tail(a), v = targets[a];
+    auto endpoint = [&](int x) { return ws.incrementalSource[x] || x == ws.incrementalTarget; };
+    int surplus = endpoint(u) ? 0 : excess;
+    int deficit = endpoint(v) ? 0 : excess;
+    int end;
+    while (surplus > 0) {
+        int f = cancelFlowPath(ws, u, surplus, true, deficit > 0 ? v : -1, end);
+        if (f == 0) break;
+        surplus -= f;
+        if (end == v) deficit -= f;
+    }
+    while (surplus == 0 && deficit > 0) {
+        int f = cancelFlowPath(ws, v, deficit, false, -1, end);
+        if (f == 0) break;
+        deficit -= f;
+    }
+    if (surplus > 0 || deficit > 0) {
+        // the flow is no longer valid, it is computed again from scratch
+        std::fill(ws.flow.begin(), ws.flow.end(), 0);
+    }
+}
+
+int CSRGraph::cancelFlowPath(FlowWorkspace &ws, int v, int limit, bool backward, int stop, int &end) const {
+    ws.clearVisited();
+    int head = 0, size = 0;
+    ws.setVisited(v);
+    ws.parent[v] = -1;
+    ws.queue[size++] = v;
+    end = -1;
+    while (head < size && end == -1) {
+        int x = ws.queue[head++];
+        for (int a = offsets[x]; a < offsets[x + 1]; a++) {
+            int w = targets[a];
+            // going backward, the flow comes to x from w, so it is negative on the arc from x to w
+            if (ws.isVisited(w) || (backward ? ws.flow[a] >= 0 : ws.flow[a] <= 0)) continue;
+            ws.setVisited(w);
+            ws.parent[w] = a;
+            ws.queue[size++] = w;
+            if (ws.incrementalSource[w] || w == ws.incrementalTarget || w == stop) {
+                end = w;
+                break;
+            }
+        }
+    }
+    if (end == -1) return 0;
+
+    int f = limit;
+    for (int w = end; w != v; w = tail(ws.parent[w])) {
+        f = std::min(f, std::abs(ws.flow[ws.parent[w]]));
+    }
+    int delta = backward ? f : -f;
+    for (int w = end; w != v; w = tail(ws.parent[w])) {
+        ws.flow[ws.parent[w]] += delta;
+        ws.flow[reverse[ws.parent[w]]] -= delta;
+    }
+    return f;
+}
+
+bool CSRGraph::buildLevelGraph(FlowWorkspace& ws, const std::vector<int>& sources, int t) const {
+    int c = component[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        ws.level[componentMembers[i]] = -1;
+    }
+    int head = 0, size = 0;
+    for (int s : sources) {
+        ws.level[s] = 0;
+        ws.queue[size++] = s;
+    }
+    while (head < size) {
+        int v = ws.queue[head++];
+        if (ws.level[v] >= ws.level[t] && ws.level[t] != -1) break;
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+            int w = targets[a];
+            if (ws.level[w] == -1 && capacity[a] - ws.flow[a] > 0) {
+                ws.level[w] = ws.level[v] + 1;
+                ws.queue[size++] = w;
+            }
+        }
+    }
+    return ws.level[t] != -1;
+}
+
+int CSRGraph::sendBlockingPath(FlowWorkspace& ws, int s, int t) const {
+    int depth = 0;
+    int v = s;
+    while (true) {
+        if (v == t) {
+            int f = INT_MAX;
+            for (int i = 0; i < depth; i++) {
+                f = std::min(f, capacity[ws.stack[i]] - ws.flow[ws.stack[i]]);
+            }
+            for (int i = 0; i < depth; i++) {
+                ws.flow[ws.stack[i]] += f;
+                ws.flow[reverse[ws.stack[i]]] -= f;
+            }
+            return f;
+        }
+        int &a = ws.current[v];
+        while (a < offsets[v + 1] && !(capacity[a] - ws.flow[a] > 0 && ws.level[targets[a]] == ws.level[v] + 1)) {
+            a++;
+        }
+        if (a < offsets[v + 1]) {
+            ws.stack[depth++] = a;
+            v = targets[a];
+            continue;
+        }
+        // dead end, v can not reach t anymore in this level graph
+        ws.level[v] = -1;
+        if (depth == 0) return 0;
+        v = tail(ws.stack[--depth]);
+        ws.current[v]++;
+    }
+}
+
+unsigned long CSRGraph::dinic(FlowWorkspace& ws, const std::vector<int>& sources, int t) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    resetFlow(ws, t);
+    int c = component[t];
+    unsigned long max_flow = 0;
+    while (buildLevelGraph(ws, sources, t)) {
+        for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+            ws.current[componentMembers[i]] = offsets[componentMembers[i]];
+        }
+        for (int s : sources) {
+            int f;
+            while ((f = sendBlockingPath(ws, s, t)) > 0) {
+                max_flow += f;
+            }
+        }
+    }
+    return max_flow;
+}
+
+void CSRGraph::addToBucket(FlowWorkspace& ws, int v) const {
+    int h = ws.level[v];
+    ws.bucketPrev[v] = -1;
+    ws.bucketNext[v] = ws.bucketHead[h];
+    if (ws.bucketHead[h] != -1) ws.bucketPrev[ws.bucketHead[h]] = v;
+    ws.bucketHead[h] = v;
+    ws.maxHeight = std::max(ws.maxHeight, h);
+    ws.highestBucket = std::max(ws.highestBucket, h);
+}
+
+void CSRGraph::removeFromBucket(FlowWorkspace& ws, int v) const {
+    int h = ws.level[v];
+    if (ws.bucketPrev[v] != -1) ws.bucketNext[ws.bucketPrev[v]] = ws.bucketNext[v];
+    else ws.bucketHead[h] = ws.bucketNext[v];
+    if (ws.bucketNext[v] != -1) ws.bucketPrev[ws.bucketNext[v]] = ws.bucketPrev[v];
+}
+
+void CSRGraph::globalRelabel(FlowWorkspace& ws, int t) const {
+    int n = getNumVertex();
+    int c = component[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        ws.level[componentMembers[i]] = n;
+    }
+    std::fill(ws.activeHead.begin(), ws.activeHead.begin() + ws.highestBucket + 1, -1);
+    std::fill(ws.bucketHead.begin(), ws.bucketHead.begin() + ws.highestBucket + 1, -1);
+    ws.maxActive = ws.maxHeight = ws.highestBucket = -1;
+
+    int head = 0, size = 0;
+    ws.level[t] = 0;
+    ws.queue[size++] = t;
+    while (head < size) {
+        int v = ws.queue[head++];
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+            int w = targets[a];
+            int r = reverse[a];
+            if (ws.level[w] == n && !ws.source[w] && capacity[r] - ws.flow[r] > 0) {
+                ws.level[w] = ws.level[v] + 1;
+                ws.queue[size++] = w;
+            }
+        }
+    }
+    for (int i = 1; i < size; i++) {
+        int v = ws.queue[i];
+        ws.current[v] = offsets[v];
+        addToBucket(ws, v);
+        if (ws.excess[v] > 0) {
+            ws.activeNext[v] = ws.activeHead[ws.level[v]];
+            ws.activeHead[ws.level[v]] = v;
+            ws.maxActive = std::max(ws.maxActive, ws.level[v]);
+            ws.highestBucket = std::max(ws.highestBucket, ws.level[v]);
+        }
+    }
+}
+
+long CSRGraph::discharge(FlowWorkspace& ws, int v, int t) const {
+    int n = getNumVertex();
+    long work = 0;
+    while (ws.excess[v] > 0) {
+        int &a = ws.current[v];
+        for (; a < offsets[v + 1]; a++) {
+            int w = targets[a];
+            int residual = capacity[a] - ws.flow[a];
+            if (residual > 0 && ws.level[w] == ws.level[v] - 1) {
+                int d = (int) std::min<long long>(ws.excess[v], residual);
+                ws.flow[a] += d;
+                ws.flow[reverse[a]] -= d;
+                ws.excess[v] -= d;
+                if (w != t && ws.excess[w] == 0) {
+                    ws.activeNext[w] = ws.activeHead[ws.level[w]];
+                    ws.activeHead[ws.level[w]] = w;
+                    ws.maxActive = std::max(ws.maxActive, ws.level[w]);
+                    ws.highestBucket = std::max(ws.highestBucket, ws.level[w]);
+                }
+                ws.excess[w] += d;
+                if (ws.excess[v] == 0) break;
+            }
+        }
+        if (ws.excess[v] == 0) break;
+
+        // relabel, or every vertex above an emptied height is cut from t
+        int h = ws.level[v];
+        if (ws.bucketHead[h] == v && ws.bucketNext[v] == -1) {
+            for (int k = h; k <= ws.maxHeight; k++) {
+                for (int u = ws.bucketHead[k]; u != -1; u = ws.bucketNext[u]) {
+                    ws.level[u] = n;
+                }
+                ws.bucketHead[k] = -1;
+            }
+            ws.maxHeight = h - 1;
+            break;
+        }
+        removeFromBucket(ws, v);
+        int newHeight = n;
+        for (int b = offsets[v]; b < offsets[v + 1]; b++) {
+            if (capacity[b] - ws.flow[b] > 0 && ws.level[targets[b]] + 1 < newHeight) {
+                newHeight = ws.level[targets[b]] + 1;
+                a = b;
+            }
+        }
+        work += offsets[v + 1] - offsets[v] + 12;
+        ws.level[v] = newHeight;
+        if (newHeight >= n) break;
+        addToBucket(ws, v);
+    }
+    return work;
+}
+
+unsigned long CSRGraph::pushRelabel(FlowWorkspace& ws, const std::vector<int>& sources, int t) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    int n = getNumVertex();
+    int m = getNumArcs();
+    resetFlow(ws, t);
+    int c = component[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        ws.excess[componentMembers[i]] = 0;
+        ws.source[componentMembers[i]] = false;
+    }
+    for (int s : sources) {
+        ws.source[s] = true;
+    }
+    for (int s : sources) {
+        for (int a = offsets[s]; a < offsets[s + 1]; a++) {
+            int w = targets[a];
+            int residual = capacity[a] - ws.flow[a];
+            if (residual > 0 && !ws.source[w]) {
+                ws.flow[a] += residual;
+                ws.flow[reverse[a]] -= residual;
+                ws.excess[w] += residual;
+            }
+        }
+    }
+
+    globalRelabel(ws, t);
+    long work = 0;
+    while (ws.maxActive >= 0) {
+        int v = ws.activeHead[ws.maxActive];
+        if (v == -1) {
+            ws.maxActive--;
+            continue;
+        }
+        ws.activeHead[ws.maxActive] = ws.activeNext[v];
+        if (ws.level[v] != ws.maxActive || ws.excess[v] == 0) continue;
+        work += discharge(ws, v, t);
+        if (work > 6L * n + m) {
+            globalRelabel(ws, t);
+            work = 0;
+        }
+    }
+    return ws.excess[t];
+}
+
+void CSRGraph::findMinCut(FlowWorkspace& ws, int t, std::vector<char> &sourceSide) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    sourceSide.assign(getNumVertex(), true);
+    int head = 0, size = 0;
+    sourceSide[t] = false;
+    ws.queue[size++] = t;
+    while (head < size) {
+        int v = ws.queue[head++];
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+            int w = targets[a];
+            int r = reverse[a];
+            if (sourceSide[w] && capacity[r] - ws.flow[r] > 0) {
+                sourceSide[w] = false;
+                ws.queue[size++] = w;
+            }
+        }
+    }
+}
+
+int CSRGraph::findComponents(std::vector<int> &result) const {
+    result = component;
+    return getNumComponents();
+}
+
+int CSRGraph::getNumComponents() const {
+    return componentOffsets.size() - 1;
+}
+
+int CSRGraph::getComponent(int i) const {
+    return component[i];
+}
+
+void CSRGraph::BFS(FlowWorkspace& ws, int n, std::vector<int> &leaves, bool skipRemoved) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    ws.clearVisited();
+    int head = 0, size = 0;
+    ws.queue[size++] = n;
+    ws.setVisited(n);
+    while (head < size) {
+        int p = ws.queue[head++];
+        bool check = true;
+        for (int a = offsets[p]; a < offsets[p + 1]; a++) {
+            int d = targets[a];
+            if (!ws.isVisited(d) && real[a] && service[a] == Service::STANDARD
+                && !(skipRemoved && ws.removedArc[a])) {
+                ws.setVisited(d);
+                check = false;
+                ws.queue[size++] = d;
+            }
+        }
+        if (check) {
+            leaves.push_back(p);
+        }
+    }
+}
+
+void CSRGraph::findInflowSources(FlowWorkspace &ws, int t, std::vector<int> &sources, bool skipRemoved) const {
+    sources.clear();
+    BFS(ws, t, sources, skipRemoved);
+    // the super-source takes the line of the first leaf, so the flow is 0 if that leaf is on another line
+    if (!sources.empty() && line[sources[0]] != line[t]) {
+        sources.clear();
+    }
+}
+
+void CSRGraph::prims(FlowWorkspace& ws, int s) const {
+    ws.prepare(getNumVertex(), getNumArcs());
+    ws.clearVisited();
+    int c = component[s];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        ws.parent[componentMembers[i]] = -1;
+        ws.dist[componentMembers[i]] = INF;
+    }
+
+    IndexedHeap<double>& p = ws.distHeap;
+    p.clear();
+    ws.dist[s] = 0;
+    p.push(s, 0);
+    long pushes = 1, pops = 0;
+    while (!p.empty()) {
+        int node = p.pop();
+        pops++;
+        ws.setVisited(node);
+        for (int a = offsets[node]; a < offsets[node + 1]; a++) {
+            if (!real[a]) continue;
+            int d = targets[a];
+            double temp = (double) cost[a] * capacity[a];
+            if (!ws.isVisited(d) && ws.dist[d] > temp) {
+                ws.dist[d] = temp;
+                ws.parent[d] = a;
+                p.push(d, temp);
+                pushes++;
+            }
+        }
+    }
+    COUNT_EVENTS(PRIM_HEAP_PUSHES, pushes);
+    COUNT_EVENTS(PRIM_HEAP_POPS, pops);
+}
+
+FlowWithCost CSRGraph::minCostMaxFlow(FlowWorkspace &ws, int s, int t) const {
+    FlowWithCost result;
+    if (line[s] != line[t] || component[s] != component[t] || s == t) return result;
+    ws.prepare(getNumVertex(), getNumArcs());
+    resetFlow(ws, t);
+    int c = component[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        ws.potential[componentMembers[i]] = 0;
+    }
+
+    while (findCheapestPath(ws, s, t)) {
+        int f = INT_MAX;
+        for (int v = t; v != s; v = tail(ws.parent[v])) {
+            f = std::min(f, costResidual(ws, ws.parent[v]));
+        }
+        long long cost = 0;
+        for (int v = t; v != s; v = tail(ws.parent[v])) {
+            int a = ws.parent[v];
+            cost += arcCost(ws, a);
+            ws.flow[a] += f;
+            ws.flow[reverse[a]] -= f;
+        }
+        result.flow += f;
+        result.cost += cost * f;
+    }
+    return result;
+}
+
+int CSRGraph::costResidual(const FlowWorkspace &ws, int a) const {
+    return ws.flow[a] < 0 ? -ws.flow[a] : capacity[a] - ws.flow[a];
+}
+
+int CSRGraph::arcCost(const FlowWorkspace &ws, int a) const {
+    return ws.flow[a] < 0 ? -cost[reverse[a]] : cost[a];
+}
+
+bool CSRGraph::findCheapestPath(FlowWorkspace &ws, int s, int t) const {
+    int c = component[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        ws.pathCost[componentMembers[i]] = LLONG_MAX;
+    }
+    ws.clearVisited();
+    IndexedHeap<long long>& p = ws.costHeap;
+    p.clear();
+    ws.pathCost[s] = 0;
+    ws.parent[s] = -1;
+    p.push(s, 0);
+    while (!p.empty()) {
+        int v = p.pop();
+        ws.setVisited(v);
+        if (v == t) break;
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+            int w = targets[a];
+            if (ws.isVisited(w) || costResidual(ws, a) <= 0) continue;
+            long long d = ws.pathCost[v] + arcCost(ws, a) + ws.potential[v] - ws.potential[w];
+            if (d < ws.pathCost[w]) {
+                ws.pathCost[w] = d;
+                ws.parent[w] = a;
+                p.push(w, d);
+            }
+        }
+    }
+    if (!ws.isVisited(t)) return false;
+
+    // vertices that were not reached or settled after t are at least as far as t
+    long long limit = ws.pathCost[t];
+    for (int i = componentOffsets[c]; i < componentOffsets[c + 1]; i++) {
+        int v = componentMembers[i];
+        ws.potential[v] += std::min(ws.pathCost[v], limit);
+    }
+    return true;
+}
+
+unsigned long CSRGraph::maxFlowAfterPrim(FlowWorkspace& ws, int s, int t) const {
+    if (line[s] != line[t] || component[s] != component[t]) return 0;
+    prims(ws, s);
+    if (ws.parent[t] == -1) return 0;
+    unsigned long maximum_flow = INT_MAX;
+    for (int v = t; v != s; v = tail(ws.parent[v])) {
+        unsigned long c = capacity[ws.parent[v]];
+        if (c < maximum_flow) {
+            maximum_flow = c;
+        }
+    }
+    return maximum_flow;
+}
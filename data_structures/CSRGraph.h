@@ -0,0 +1,471 @@
+#ifndef PROJECT_CSRGRAPH_H
+#define PROJECT_CSRGRAPH_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "Graph.h"
+#include "FlowWorkspace.h"
+
+/**
+ * Algorithms that can be used to compute a maximum flow on a CSRGraph.
+ */
+enum class FlowEngine {
+    EDMONDS_KARP,
+    DINIC,
+    PUSH_RELABEL
+};
+
+/**
+ * Value of a maximum flow and the minimum cost of sending it.
+ */
+struct FlowWithCost {
+    unsigned long flow = 0;
+    long long cost = 0;     // every unit of flow crossing a segment costs the cost of its service
+};
+
+/**
+ * Immutable compressed sparse row (adjacency array) copy of a Graph.
+ *
+ * Every Edge of the source graph becomes one arc stored contiguously in the arc range of its origin vertex.
+ * Two edges that are each other's reverse (bidirectional segments) are paired as residual arcs of one another,
+ * edges without a reverse get an extra zero capacity arc in the range of their destination.
+ * The flow and every other auxiliary array live in a FlowWorkspace, the graph itself is never written by the
+ * algorithms, so any number of threads can share it as long as each one uses its own workspace.
+ * Vertices are numbered in the order of Graph::getVertexSet(). The connected components are found when the graph is
+ * built, and every query only resets and explores the component of its target: flows between vertices of different
+ * components are 0 without any work.
+ */
+class CSRGraph {
+public:
+    CSRGraph() = default;
+
+    /**
+     * Builds the adjacency arrays from the current state of a graph.
+     *
+     * Complexity : O(V + E)
+     * @param g The graph to copy
+     */
+    explicit CSRGraph(const Graph& g);
+
+    /**
+     * @return returns the number of vertices
+     */
+    int getNumVertex() const;
+
+    /**
+     * @return returns the number of arcs, residual arcs included
+     */
+    int getNumArcs() const;
+
+    /**
+     * @param v A vertex of the graph this object was built from
+     * @return The index of v, or -1 if v is not part of the graph
+     */
+    int indexOf(const Vertex* v) const;
+
+    /**
+     * @param i Index of a vertex
+     * @return The vertex of the source graph with index i
+     */
+    Vertex* getVertex(int i) const;
+
+    /**
+     * @param i Index of a vertex
+     * @return An identifier of the line of the station of vertex i, equal for stations of the same line
+     */
+    int getLine(int i) const;
+
+    /**
+     * Complexity : O(degree of s)
+     * @param s Index of a vertex
+     * @param t Index of a vertex
+     * @return The arc of the segment from s to t, -1 if there is none
+     */
+    int findArc(int s, int t) const;
+
+    /**
+     * Computes the maximum flow from vertex s to vertex t with the chosen algorithm.
+     *
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param s Index of the source vertex
+     * @param t Index of the target vertex
+     * @param engine Algorithm used to compute the flow
+     * @return The maximum flow from s to t, 0 if the stations are on different lines or components
+     */
+    unsigned long maxFlow(FlowWorkspace& ws, int s, int t, FlowEngine engine) const;
+
+    /**
+     * Computes the maximum flow into vertex t coming from a set of sources, as if every source was connected to a
+     * super-source by an edge of unlimited capacity. The super-source is virtual, nothing is added to the graph.
+     * Repeated sources, sources equal to t and sources of other components are ignored.
+     *
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param sources Indexes of the source vertices
+     * @param t Index of the target vertex
+     * @param engine Algorithm used to compute the flow
+     * @return The maximum flow from the sources to t
+     */
+    unsigned long maxFlow(FlowWorkspace& ws, const std::vector<int>& sources, int t, FlowEngine engine) const;
+
+    /**
+     * Applies the algorithm Edmonds-Karp to find the maximum flow from vertex s to vertex t, 0 if they are on
+     * different lines.
+     *
+     * Complexity : O(VE^2)
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param s Index of the source vertex
+     * @param t Index of the target vertex
+     * @return The maximum flow from s to t, 0 if the stations are on different lines
+     */
+    unsigned int edmondsKarp(FlowWorkspace& ws, int s, int t) const;
+
+    /**
+     * Applies the algorithm Edmonds-Karp from a set of sources to vertex t.
+     *
+     * Complexity : O(VE^2)
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param sources Distinct indexes of the source vertices of the component of t, none of them equal to t
+     * @param t Index of the target vertex
+     * @return The maximum flow from the sources to t
+     */
+    unsigned long edmondsKarp(FlowWorkspace& ws, const std::vector<int>& sources, int t) const;
+
+    /**
+     * Computes the maximum flow from a set of sources to vertex t with the algorithm Edmonds-Karp and keeps it in the
+     * workspace, with a copy of the capacities of the arcs. Segments can then be removed, restored or given another
+     * capacity, and the sources changed, repairing that flow instead of computing it again: only the flow going
+     * through the changed arcs or leaving the dropped sources is cancelled, then new augmenting paths are searched.
+     * The workspace must not be used by the other maximum flow algorithms while the flow is still needed; BFS can be
+     * used, and told to skip the removed segments.
+     *
+     * Complexity : O(VE^2)
+     * @param ws Workspace that will hold the flow
+     * @param sources Indexes of the source vertices, repeated ones and t are ignored
+     * @param t Index of the target vertex
+     * @return The maximum flow from the sources to t
+     */
+    unsigned long startIncrementalFlow(FlowWorkspace& ws, const std::vector<int>& sources, int t) const;
+
+    /**
+     * Removes a segment from the incremental flow of the workspace: both of its arcs get capacity 0.
+     *
+     * Complexity : O(kE), k being the number of paths cancelled and augmented
+     * @param ws Workspace holding an incremental flow
+     * @param a One of the arcs of the segment, as returned by findArc
+     * @return The new maximum flow
+     */
+    unsigned long removeSegment(FlowWorkspace& ws, int a) const;
+
+    /**
+     * Gives back to a segment of the incremental flow of the workspace the capacity it has in the graph.
+     *
+     * Complexity : O(kE), k being the number of paths augmented
+     * @param ws Workspace holding an incremental flow
+     * @param a One of the arcs of the segment
+     * @return The new maximum flow
+     */
+    unsigned long restoreSegment(FlowWorkspace& ws, int a) const;
+
+    /**
+     * Changes the capacity of both arcs of a segment in the incremental flow of the workspace.
+     *
+     * Complexity : O(kE), k being the number of paths cancelled and augmented
+     * @param ws Workspace holding an incremental flow
+     * @param a One of the arcs of the segment
+     * @param c The new capacity
+     * @return The new maximum flow
+     */
+    unsigned long setSegmentCapacity(FlowWorkspace& ws, int a, int c) const;
+
+    /**
+     * Replaces the sources of the incremental flow of the workspace. The flow leaving or entering the sources that
+     * were dropped is cancelled, then the new sources augment it.
+     *
+     * Complexity : O(kE), k being the number of paths cancelled and augmented
+     * @param ws Workspace holding an incremental flow
+     * @param sources Indexes of the new source vertices, repeated ones and the target are ignored
+     * @return The new maximum flow
+     */
+    unsigned long setIncrementalSources(FlowWorkspace& ws, const std::vector<int>& sources) const;
+
+    /**
+     * Applies Dinic's algorithm from a set of sources to vertex t: builds the level graph with a BFS and saturates
+     * it with a blocking flow until t is no longer reachable.
+     *
+     * Complexity : O(V^2 E)
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param sources Distinct indexes of the source vertices of the component of t, none of them equal to t
+     * @param t Index of the target vertex
+     * @return The maximum flow from the sources to t
+     */
+    unsigned long dinic(FlowWorkspace& ws, const std::vector<int>& sources, int t) const;
+
+    /**
+     * Applies the highest-label push-relabel algorithm from a set of sources to vertex t, with the gap and global
+     * relabeling heuristics. Only the maximum preflow is computed, which is enough to know the value of the flow:
+     * excess that can not reach t is left where it is instead of being returned to the sources.
+     *
+     * Complexity : O(V^2 sqrt(E))
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param sources Distinct indexes of the source vertices of the component of t, none of them equal to t
+     * @param t Index of the target vertex
+     * @return The maximum flow from the sources to t
+     */
+    unsigned long pushRelabel(FlowWorkspace& ws, const std::vector<int>& sources, int t) const;
+
+    /**
+     * Finds a minimum cut after one of the maximum flow algorithms ran with target t: the vertices that can not reach
+     * t in the residual graph are on the source side of the cut.
+     *
+     * Complexity : O(V + E)
+     * @param ws Workspace holding the flow of the last maximum flow computed
+     * @param t Index of the target vertex of that flow
+     * @param sourceSide Vector that will tell, for every vertex, if it is on the source side of the cut
+     */
+    void findMinCut(FlowWorkspace& ws, int t, std::vector<char>& sourceSide) const;
+
+    /**
+     * Labels every vertex with the connected component it belongs to, numbered from 0 in order of their smallest
+     * vertex index.
+     *
+     * Complexity : O(V)
+     * @param component Vector that will contain the component of every vertex
+     * @return The number of components
+     */
+    int findComponents(std::vector<int>& component) const;
+
+    /**
+     * @return returns the number of connected components
+     */
+    int getNumComponents() const;
+
+    /**
+     * @param i Index of a vertex
+     * @return The connected component of vertex i, as numbered by findComponents
+     */
+    int getComponent(int i) const;
+
+    /**
+     * Performs a Breath-First Search through STANDARD segments and stores the leaf nodes of the resulting tree
+     * with root n.
+     *
+     * Complexity : O(V + E)
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param n Index of the root vertex
+     * @param leaves Empty vector which will contain the indexes of the leaf nodes upon exiting
+     * @param skipRemoved Whether to skip the segments removed from the incremental flow of the workspace, which
+     * must hold one
+     */
+    void BFS(FlowWorkspace& ws, int n, std::vector<int>& leaves, bool skipRemoved = false) const;
+
+    /**
+     * Finds the sources of the maximum flow arriving at vertex t: the leaves of BFS from t, or none if the first of
+     * them is on another line, in which case the flow is 0.
+     *
+     * Complexity : O(V + E)
+     * @param ws Workspace used by the BFS
+     * @param t Index of the target vertex
+     * @param sources Vector that will contain the indexes of the sources
+     * @param skipRemoved Whether to skip the segments removed from the incremental flow of the workspace
+     */
+    void findInflowSources(FlowWorkspace& ws, int t, std::vector<int>& sources, bool skipRemoved = false) const;
+
+    /**
+     * Performs the prims algorithm, a segment costing its capacity times the cost of its service.
+     * The tree is kept in the parent arc of the vertices of the component of s in the workspace.
+     *
+     * Complexity : O(E log V)
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param s Index of the source vertex
+     */
+    void prims(FlowWorkspace& ws, int s) const;
+
+    /**
+     * Computes the maximum flow from vertex s to vertex t that has the minimum cost, a unit of flow crossing a
+     * segment costing the cost of its service, with successive shortest paths: the cheapest augmenting path is found
+     * by Dijkstra's algorithm on costs reduced by Johnson potentials, which stay non-negative as the flow grows.
+     * Sending flow against the flow of a segment cancels it and gives back its cost.
+     * The costs of the services must not be negative.
+     *
+     * Complexity : O(F E log V), F being the number of augmenting paths
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param s Index of the source vertex
+     * @param t Index of the target vertex
+     * @return The maximum flow and its minimum cost, both 0 if the stations are on different lines or components
+     */
+    FlowWithCost minCostMaxFlow(FlowWorkspace& ws, int s, int t) const;
+
+    /**
+     * Finds the maximum flow along the path from s to t of the tree computed by the prims algorithm.
+     *
+     * Complexity : O(E log V)
+     * @param ws Workspace holding the flow and the auxiliary arrays
+     * @param s Index of the source vertex
+     * @param t Index of the target vertex
+     * @return The minimum capacity on the tree path, 0 if there is none or the stations are on different lines
+     */
+    unsigned long maxFlowAfterPrim(FlowWorkspace& ws, int s, int t) const;
+
+private:
+    /**
+     * Finds the connected components and lists the vertices of each one.
+     *
+     * Complexity : O(V + E)
+     */
+    void buildComponents();
+
+    /**
+     * @return The sources of the component of t, without repetitions and without t, sorted
+     */
+    std::vector<int> distinctSources(const std::vector<int>& sources, int t) const;
+
+    /**
+     * Sets to 0 the flow of every arc of the component of t.
+     *
+     * Complexity : O(V + E) of the component
+     */
+    void resetFlow(FlowWorkspace& ws, int t) const;
+
+    /**
+     * Finds a shortest path in the residual graph between any of the sources and t, updating the parent arc of the
+     * vertices. The parent arc of the sources is -1.
+     *
+     * Complexity : O(V + E)
+     * @param cap Capacity of every arc
+     * @return Returns true if successful, false if no path exists between the sources and t
+     */
+    bool findAugmentingPath(FlowWorkspace& ws, const std::vector<int>& sources, int t,
+                            const std::vector<int>& cap) const;
+
+    /**
+     * Complexity : O(V)
+     * @param cap Capacity of every arc
+     * @return The minimum residual capacity along the path found by findAugmentingPath
+     */
+    int findMinResidualAlongPath(const FlowWorkspace& ws, int t, const std::vector<int>& cap) const;
+
+    /**
+     * Augments the incremental flow of the workspace until it is maximum.
+     *
+     * Complexity : O(kE), k being the number of paths augmented
+     * @return The value of the flow
+     */
+    unsigned long augmentIncrementalFlow(FlowWorkspace& ws) const;
+
+    /**
+     * Sets the capacity of arc a in the incremental flow. When the arc carries more flow than c, the difference is
+     * cancelled: first along flow paths between the two ends of the arc, then back to the sources from its origin and
+     * on to the target from its destination. Should some of it have nowhere to go, the flow is reset to 0, to be
+     * augmented again from scratch.
+     *
+     * Complexity : O(kE), k being the number of paths cancelled
+     */
+    void changeCapacity(FlowWorkspace& ws, int a, int c) const;
+
+    /**
+     * Cancels the flow that vertex v sends or receives beyond what it receives or sends, along paths of arcs carrying
+     * flow to or from the sources and the target, until v receives as much as it sends.
+     *
+     * Complexity : O(kE), k being the number of paths cancelled
+     * @return false if some flow could not be cancelled, which only happens when a vertex other than the sources
+     * and the target was not balanced already
+     */
+    bool cancelNetFlow(FlowWorkspace& ws, int v) const;
+
+    /**
+     * Finds a path of arcs carrying flow, forward from v or backward to v, that ends at a source, at the target or at
+     * the vertex stop, and cancels up to limit units of flow along it.
+     *
+     * Complexity : O(V + E)
+     * @param end Will contain the vertex where the path ends
+     * @return The flow cancelled, 0 if there is no such path
+     */
+    int cancelFlowPath(FlowWorkspace& ws, int v, int limit, bool backward, int stop, int& end) const;
+
+    /**
+     * Adds f units of flow along the path found by findAugmentingPath.
+     *
+     * Complexity : O(V)
+     */
+    void augmentFlowAlongPath(FlowWorkspace& ws, int t, int f) const;
+
+    /**
+     * Finds the cheapest path from s to t in the residual graph, with the costs reduced by the potentials, and
+     * updates the potentials with the reduced cost of the path to every vertex (at most the one of t), so that the
+     * reduced costs stay non-negative. The path is kept in the parent arc of the vertices.
+     *
+     * Complexity : O(E log V)
+     * @return true if t can be reached from s
+     */
+    bool findCheapestPath(FlowWorkspace& ws, int s, int t) const;
+
+    /**
+     * @return The capacity left on arc a when sending flow along it: the flow of its reverse when there is some to
+     * cancel, otherwise what is left of its own capacity
+     */
+    int costResidual(const FlowWorkspace& ws, int a) const;
+
+    /**
+     * @return The cost of a unit of flow sent along arc a, negative when it cancels flow of the reverse arc
+     */
+    int arcCost(const FlowWorkspace& ws, int a) const;
+
+    /**
+     * Computes the distance in the residual graph from the sources to every vertex, stopping at the level of t.
+     *
+     * Complexity : O(V + E)
+     * @return true if t is reachable from the sources
+     */
+    bool buildLevelGraph(FlowWorkspace& ws, const std::vector<int>& sources, int t) const;
+
+    /**
+     * Sends one augmenting path of flow from s to t in the level graph, advancing the current arc of the vertices
+     * and removing dead ends from the level graph.
+     *
+     * Complexity : O(V) amortized over the blocking flow
+     * @return The flow sent, 0 if t can no longer be reached from s
+     */
+    int sendBlockingPath(FlowWorkspace& ws, int s, int t) const;
+
+    /**
+     * Sets the height of every vertex to its distance to t in the residual graph (or V if t can not be reached)
+     * and rebuilds the buckets of the push-relabel algorithm.
+     *
+     * Complexity : O(V + E)
+     */
+    void globalRelabel(FlowWorkspace& ws, int t) const;
+
+    /**
+     * Pushes the excess of v to admissible arcs, relabeling v when there are none, until v has no excess left or
+     * can no longer reach t. Applies the gap heuristic when v leaves an otherwise empty height.
+     *
+     * @return The work done, used to decide when to do a global relabel
+     */
+    long discharge(FlowWorkspace& ws, int v, int t) const;
+
+    void addToBucket(FlowWorkspace& ws, int v) const;
+    void removeFromBucket(FlowWorkspace& ws, int v) const;
+
+    /**
+     * @return The vertex arc a comes from
+     */
+    int tail(int a) const;
+
+    std::vector<Vertex*> vertices;
+    std::unordered_map<const Vertex*, int> index;
+    std::vector<int> line;
+    std::vector<int> component;
+    std::vector<int> componentOffsets;  // vertices of component c are componentMembers[componentOffsets[c]..[c+1])
+    std::vector<int> componentMembers;
+
+    std::vector<int> offsets;       // arcs of vertex v are [offsets[v], offsets[v+1])
+    std::vector<int> targets;
+    std::vector<int> capacity;
+    std::vector<int> reverse;       // index of the residual arc
+    std::vector<char> real;         // false for the zero capacity arcs added for edges without reverse
+    std::vector<unsigned int> service;  // Service identifier of the segment
+    std::vector<int> cost;          // cost of the service when the graph was built, 0 for the added arcs
+};
+
+#endif //PROJECT_CSRGRAPH_H
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include "FailureScenarioEngine.h"
+#include "Instrumentation.h"
+
+FailureScenarioEngine::FailureScenarioEngine(const CSRGraph &network, ParallelFlowDriver &driver)
+        : network(network), driver(driver) {}
+
+FailureScenarioEngine::Scenario FailureScenarioEngine::lineSection(const std::vector<int> &stations) {
+    Scenario scenario;
+    for (size_t i = 1; i < stations.size(); i++) {
+        scenario.emplace_back(stations[i - 1], stations[i]);
+    }
+    return scenario;
+}
+
+std::vector<std::vector<StationImpact>> FailureScenarioEngine::evaluate(const std::vector<Scenario> &scenarios) {
+    TIME_PHASE(FAILURE_SCENARIOS);
+    int n = network.getNumVertex();
+    int count = scenarios.size();
+
+    // arcs of the segments of every scenario, and the lines they affect
+    std::vector<std::vector<int>> arcs(count);
+    std::vector<std::vector<int>> lines(count);
+    for (int s = 0; s < count; s++) {
+        for (const auto& segment : scenarios[s]) {
+            if (segment.first < 0 || segment.first >= n || segment.second < 0 || segment.second >= n) continue;
+            int a = network.findArc(segment.first, segment.second);
+            if (a == -1) continue;
+            arcs[s].push_back(a);
+            lines[s].push_back(network.getLine(segment.first));
+        }
+        std::sort(lines[s].begin(), lines[s].end());
+        lines[s].erase(std::unique(lines[s].begin(), lines[s].end()), lines[s].end());
+    }
+
+    // each station writes the scenarios that changed its flow to its own slot
+    std::vector<std::vector<std::pair<int, StationImpact>>> changes(n);
+    driver.run(n, [&](int v, FlowWorkspace& ws){
+        std::vector<int> sources;
+        bool started = false;
+        unsigned long before = 0;
+        for (int s = 0; s < count; s++) {
+            if (arcs[s].empty() || !std::binary_search(lines[s].begin(), lines[s].end(), network.getLine(v))) {
+                continue;
+            }
+            if (!started) {
+                network.findInflowSources(ws, v, sources);
+                before = network.startIncrementalFlow(ws, sources, v);
+                started = true;
+            }
+            for (int a : arcs[s]) {
+                network.removeSegment(ws, a);
+            }
+            network.findInflowSources(ws, v, sources, true);
+            unsigned long after = network.setIncrementalSources(ws, sources);
+            if (after != before) changes[v].push_back({s, {v, before, after}});
+
+            for (int a : arcs[s]) {
+                network.restoreSegment(ws, a);
+            }
+            network.findInflowSources(ws, v, sources);
+            network.setIncrementalSources(ws, sources);
+        }
+    });
+
+    std::vector<std::vector<StationImpact>> impacts(count);
+    for (int v = 0; v < n; v++) {
+        for (const auto& change : changes[v]) {
+            impacts[change.first].push_back(change.second);
+        }
+    }
+    driver.run(count, [&](int s, FlowWorkspace&){
+        std::sort(impacts[s].begin(), impacts[s].end(), [](const StationImpact& a, const StationImpact& b){
+            if (a.change() != b.change()) return a.change() > b.change();
+            return a.station < b.station;
+        });
+    });
+    return impacts;
+}
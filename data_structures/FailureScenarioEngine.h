@@ -0,0 +1,72 @@
+#ifndef PROJECT_FAILURESCENARIOENGINE_H
+#define PROJECT_FAILURESCENARIOENGINE_H
+
+#include <utility>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "ParallelFlowDriver.h"
+
+/**
+ * Change of the maximum flow arriving at a station caused by a failure scenario.
+ */
+struct StationImpact {
+    int station;            // index of the station in the network
+    unsigned long before;   // flow arriving at the station in the whole network
+    unsigned long after;    // flow arriving at the station when the segments of the scenario fail
+
+    /**
+     * @return The absolute difference between the two flows
+     */
+    unsigned long change() const {
+        return after > before ? after - before : before - after;
+    }
+};
+
+/**
+ * Evaluates batches of failure scenarios, each one being a set of segments that fail together: single segments,
+ * pairs, whole sections of a line...
+ *
+ * The network is never modified. Every worker thread of the driver takes one station at a time, computes the
+ * maximum flow arriving at it (see CSRGraph::findInflowSources) once on the whole network, and then, for each
+ * scenario with a segment on its line, removes the segments from the incremental flow of its workspace, repairs
+ * the flow, reads it and restores the segments.
+ */
+class FailureScenarioEngine {
+public:
+    /**
+     * A set of segments that fail together, each one given by the indexes of the two stations it connects.
+     */
+    using Scenario = std::vector<std::pair<int, int>>;
+
+    /**
+     * @param network The network the scenarios are applied to, which must outlive the engine
+     * @param driver Threads that evaluate the scenarios
+     */
+    FailureScenarioEngine(const CSRGraph& network, ParallelFlowDriver& driver);
+
+    /**
+     * Builds the scenario of a section of a line, in which every segment between consecutive stations fails.
+     *
+     * Complexity : O(n)
+     * @param stations Indexes of the stations of the section, in order
+     * @return The scenario
+     */
+    static Scenario lineSection(const std::vector<int>& stations);
+
+    /**
+     * Evaluates every scenario against the stations on the lines of its segments (the line of the first station of
+     * each segment). Segments that are not part of the network are ignored.
+     *
+     * Complexity : O(V (VE^2 + S k E)), S being the number of scenarios and k the number of paths repaired each time
+     * @param scenarios The failure scenarios
+     * @return For every scenario, the stations whose flow changed, sorted by decreasing change and then by index
+     */
+    std::vector<std::vector<StationImpact>> evaluate(const std::vector<Scenario>& scenarios);
+
+private:
+    const CSRGraph& network;
+    ParallelFlowDriver& driver;
+};
+
+#endif //PROJECT_FAILURESCENARIOENGINE_H
@@ -0,0 +1,98 @@
+#ifndef PROJECT_FLOWWORKSPACE_H
+#define PROJECT_FLOWWORKSPACE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "IndexedHeap.h"
+
+/**
+ * Flow and auxiliary arrays used by the algorithms of a CSRGraph, indexed by vertex or arc index.
+ *
+ * Keeping them outside of the graph lets several threads run algorithms on the same graph at the same time, each
+ * one with its own workspace. A workspace can be reused for any number of queries, it is only reallocated when
+ * it is used with a graph of a different size.
+ */
+struct FlowWorkspace {
+    /**
+     * Makes sure every array has the right size for a graph.
+     *
+     * Complexity : O(1), or O(V + E) when the size changed
+     * @param numVertex Number of vertices of the graph
+     * @param numArcs Number of arcs of the graph
+     */
+    void prepare(int numVertex, int numArcs) {
+        if ((int) visited.size() == numVertex && (int) flow.size() == numArcs) return;
+        flow.assign(numArcs, 0);
+        visited.assign(numVertex, 0);
+        parent.assign(numVertex, -1);
+        dist.assign(numVertex, 0);
+        potential.assign(numVertex, 0);
+        pathCost.assign(numVertex, 0);
+        distHeap.resize(numVertex);
+        costHeap.resize(numVertex);
+        queue.resize(numVertex);
+        level.assign(numVertex, -1);
+        current.assign(numVertex, 0);
+        stack.resize(numVertex);
+        excess.assign(numVertex, 0);
+        source.assign(numVertex, false);
+        activeHead.assign(numVertex, -1);
+        activeNext.assign(numVertex, -1);
+        bucketHead.assign(numVertex, -1);
+        bucketNext.assign(numVertex, -1);
+        bucketPrev.assign(numVertex, -1);
+    }
+
+    /**
+     * Starts a new traversal, after which no vertex is visited.
+     *
+     * Complexity : O(1), O(V) once every 2^32 traversals
+     */
+    void clearVisited() {
+        if (++visitEpoch == 0) {
+            std::fill(visited.begin(), visited.end(), 0);
+            visitEpoch = 1;
+        }
+    }
+
+    bool isVisited(int v) const {
+        return visited[v] == visitEpoch;
+    }
+
+    void setVisited(int v) {
+        visited[v] = visitEpoch;
+    }
+
+    std::vector<int> flow;
+
+    std::vector<unsigned int> visited;  // traversal in which each vertex was last visited
+    unsigned int visitEpoch = 0;
+    std::vector<int> parent;        // arc used to reach each vertex
+    std::vector<double> dist;
+    std::vector<long long> potential;   // Johnson potential of every vertex in the minimum cost flow
+    std::vector<long long> pathCost;    // reduced cost of the cheapest path found to every vertex
+    IndexedHeap<double> distHeap;       // vertices to visit next in prims, by dist
+    IndexedHeap<long long> costHeap;    // vertices to visit next in the cheapest path search, by pathCost
+    std::vector<int> queue;
+    std::vector<int> level;
+    std::vector<int> current;       // current arc of every vertex during a blocking flow
+    std::vector<int> stack;
+
+    // push-relabel buckets, the active ones are stacks and the others doubly linked lists of every vertex by height
+    std::vector<long long> excess;
+    std::vector<char> source;
+    std::vector<int> activeHead, activeNext;
+    std::vector<int> bucketHead, bucketNext, bucketPrev;
+    int maxActive = -1, maxHeight = -1;
+    int highestBucket = -1;         // the buckets of every greater height are empty
+
+    // incremental maximum flow, kept in flow between the calls that repair it (see CSRGraph::startIncrementalFlow)
+    std::vector<int> incrementalCapacity;   // capacity of every arc, 0 for the removed segments
+    std::vector<char> removedArc;           // arcs of the segments removed, which CSRGraph::BFS can skip
+    std::vector<char> incrementalSource;
+    std::vector<int> incrementalSources;
+    int incrementalTarget = -1;
+};
+
+#endif //PROJECT_FLOWWORKSPACE_H
@@ -0,0 +1,114 @@
+#include <climits>
+#include "GomoryHuTree.h"
+#include "Instrumentation.h"
+
+GomoryHuTree::GomoryHuTree(const CSRGraph &network, FlowEngine engine, ParallelFlowDriver &driver) {
+    TIME_PHASE(CUT_TREE);
+    int n = network.getNumVertex();
+    int numComponents = network.findComponents(component);
+    std::vector<std::vector<int>> members(numComponents);
+    for (int v = 0; v < n; v++) {
+        members[component[v]].push_back(v);
+    }
+
+    // every vertex starts attached to the first vertex of its component
+    parent.assign(n, -1);
+    parentFlow.assign(n, 0);
+    for (auto& m : members) {
+        for (int v : m) {
+            if (v != m[0]) parent[v] = m[0];
+        }
+    }
+
+    driver.run(numComponents, [&](int c, FlowWorkspace& ws) {
+        const std::vector<int>& m = members[c];
+        std::vector<char> sourceSide;
+        for (int k = 1; k < (int) m.size(); k++) {
+            int s = m[k];
+            int t = parent[s];
+            parentFlow[s] = network.maxFlow(ws, std::vector<int>{s}, t, engine);
+            COUNT_EVENTS(CUT_TREE_FLOWS, 1);
+            network.findMinCut(ws, t, sourceSide);
+            for (int i = k + 1; i < (int) m.size(); i++) {
+                if (parent[m[i]] == t && sourceSide[m[i]]) parent[m[i]] = s;
+            }
+        }
+    });
+
+    offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        if (parent[v] == -1) continue;
+        offsets[v + 1]++;
+        offsets[parent[v] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    neighbours.resize(offsets[n]);
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (int v = 0; v < n; v++) {
+        if (parent[v] == -1) continue;
+        neighbours[next[v]++] = parent[v];
+        neighbours[next[parent[v]]++] = v;
+    }
+}
+
+int GomoryHuTree::getNumVertex() const {
+    return parent.size();
+}
+
+int GomoryHuTree::getParent(int v) const {
+    return parent[v];
+}
+
+unsigned long GomoryHuTree::getParentFlow(int v) const {
+    return parentFlow[v];
+}
+
+int GomoryHuTree::getComponent(int v) const {
+    return component[v];
+}
+
+unsigned long GomoryHuTree::maxFlow(int s, int t) const {
+    if (s == t || component[s] != component[t]) return 0;
+    // mark the path from s to the root with the minimum flow found so far, then climb from t until it is reached
+    std::vector<unsigned long> fromS(getNumVertex(), ULONG_MAX);
+    std::vector<char> onPath(getNumVertex(), false);
+    unsigned long f = ULONG_MAX;
+    for (int v = s; v != -1; v = parent[v]) {
+        onPath[v] = true;
+        fromS[v] = f;
+        if (parent[v] != -1) f = std::min(f, parentFlow[v]);
+    }
+    f = ULONG_MAX;
+    int v = t;
+    while (!onPath[v]) {
+        f = std::min(f, parentFlow[v]);
+        v = parent[v];
+    }
+    return std::min(f, fromS[v]);
+}
+
+void GomoryHuTree::flowsFrom(int s, std::vector<unsigned long> &flows) const {
+    int n = getNumVertex();
+    flows.assign(n, 0);
+    std::vector<char> visited(n, false);
+    std::vector<int> queue;
+    queue.reserve(n);
+    visited[s] = true;
+    flows[s] = ULONG_MAX;
+    queue.push_back(s);
+    for (int head = 0; head < (int) queue.size(); head++) {
+        int v = queue[head];
+        for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+            int w = neighbours[i];
+            if (visited[w]) continue;
+            visited[w] = true;
+            // the edge between v and w is stored in the child
+            unsigned long edge = parent[w] == v ? parentFlow[w] : parentFlow[v];
+            flows[w] = std::min(flows[v], edge);
+            queue.push_back(w);
+        }
+    }
+    flows[s] = 0;
+}
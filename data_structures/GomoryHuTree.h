@@ -0,0 +1,85 @@
+#ifndef PROJECT_GOMORYHUTREE_H
+#define PROJECT_GOMORYHUTREE_H
+
+#include <vector>
+
+#include "CSRGraph.h"
+#include "ParallelFlowDriver.h"
+
+/**
+ * Flow equivalent tree of an undirected network, built with Gusfield's algorithm.
+ *
+ * The maximum flow between any two vertices is the minimum capacity on the path between them in the tree, so the
+ * flow between all pairs is known after V - 1 maximum flow computations instead of V(V - 1)/2.
+ * Each connected component gets its own tree, vertices of different components have a flow of 0. The trees of
+ * different components are independent and are built in parallel.
+ * Vertices are identified by their index in the CSRGraph the tree was built from.
+ */
+class GomoryHuTree {
+public:
+    GomoryHuTree() = default;
+
+    /**
+     * Builds the tree of every connected component of a network whose segments have the same capacity in both
+     * directions.
+     *
+     * Complexity : O(V) maximum flow computations
+     * @param network The network
+     * @param engine Algorithm used to compute the maximum flows
+     * @param driver Threads that build the trees of the components, each with its own workspace
+     */
+    GomoryHuTree(const CSRGraph& network, FlowEngine engine, ParallelFlowDriver& driver);
+
+    /**
+     * @return returns the number of vertices
+     */
+    int getNumVertex() const;
+
+    /**
+     * @param v Index of a vertex
+     * @return The parent of v in the tree, or -1 if v is the root of its component
+     */
+    int getParent(int v) const;
+
+    /**
+     * @param v Index of a vertex
+     * @return The maximum flow between v and its parent
+     */
+    unsigned long getParentFlow(int v) const;
+
+    /**
+     * @param v Index of a vertex
+     * @return The connected component of v
+     */
+    int getComponent(int v) const;
+
+    /**
+     * Finds the minimum capacity on the tree path between s and t.
+     *
+     * Complexity : O(V)
+     * @param s Index of a vertex
+     * @param t Index of another vertex
+     * @return The maximum flow between s and t
+     */
+    unsigned long maxFlow(int s, int t) const;
+
+    /**
+     * Computes the maximum flow between s and every other vertex with a single traversal of the tree.
+     *
+     * Complexity : O(V)
+     * @param s Index of the vertex
+     * @param flows Vector that will contain the maximum flow between s and every vertex
+     */
+    void flowsFrom(int s, std::vector<unsigned long>& flows) const;
+
+private:
+    std::vector<int> parent;
+    std::vector<unsigned long> parentFlow;
+    std::vector<int> component;
+
+    // tree adjacency, the neighbours of v are [offsets[v], offsets[v+1])
+    std::vector<int> offsets;
+    std::vector<int> neighbours;
+};
+
+#endif //PROJECT_GOMORYHUTREE_H
@@ -6,31 +6,97 @@
 #include <queue>
 #include <limits>
 #include <algorithm>
-//#include "../data_structures/MutablePriorityQueue.h"
+#include <unordered_map>
 
 #include "VertexEdge.h"
 
 class Graph {
 public:
+    Graph() = default;
+    Graph(const Graph&) = delete;
+    Graph& operator=(const Graph&) = delete;
+
+    /**
+     * Frees every vertex and edge of the graph at once, by releasing the slabs they were allocated in.
+     */
     ~Graph();
 
-    Vertex *findVertex(Station &station2) const;
+    /**
+     * Finds the vertex of a station, looking it up by the name of the station first.
+     *
+     * Complexity : O(1) on average, O(V) if several stations have the same name
+     * @param station2 The station
+     * @return The vertex, or nullptr if the station is not part of the graph
+     */
+    Vertex *findVertex(const Station &station2) const;
 
+    /**
+     * Complexity : O(n) on average, n being the length of the name
+     * @param name Name of a station
+     * @return The vertex of the first station added with that name, or nullptr if there is none
+     */
     Vertex* findVertexByName(const string& name) const;
 
+    /**
+     * Complexity : O(1)
+     * @param id Identifier of the name of a station, as given by Station::getNameId
+     * @return The vertex of the first station added with that name, or nullptr if there is none
+     */
+    Vertex* findVertexByNameId(unsigned int id) const;
+
     /**
      * Adds a vertex with a given content or info (station2) to a graph (this).
      * @param station2 Vertex to add to graph
      * @return true if successful, and false if a vertex with that content already exists.
      */
-    bool addVertex(Station &station2);
+    bool addVertex(const Station &station2);
+
+    /**
+     * Adds a vertex to a graph (this) without looking for a vertex with the same content, for loaders whose
+     * stations are already known to be distinct.
+     * @param station2 Content of the vertex
+     * @return The new vertex
+     */
+    Vertex* appendVertex(const Station &station2);
 
     /**
-     * Removes a vertex with a given content or info (station2) to a graph (this).
+     * Adds an edge between two vertices of a graph (this) without looking them up. Pairing it with its reverse
+     * edge is left to the caller.
+     * @param orig Vertex which the edge comes from
+     * @param dest Vertex which the edge points to
+     * @param w Weight of the edge
+     * @param service Service provided by this segment of the train network
+     * @return The new edge
+     */
+    Edge* appendEdge(Vertex* orig, Vertex* dest, int w, const string& service);
+
+    /**
+     * Makes two edges between the same pair of vertices, in opposite directions, the reverse of each other and
+     * records them as the segment between those vertices.
+     * @param e1 An edge
+     * @param e2 The edge going the other way
+     */
+    void pairEdges(Edge* e1, Edge* e2);
+
+    /**
+     * Finds the segment between two vertices, whatever the direction it was added in.
+     *
+     * Complexity : O(1) on average
+     * @param s A vertex
+     * @param t Another vertex
+     * @return The edge of the segment that goes from s to t, or nullptr if there is none
+     */
+    Edge* findSegment(const Vertex* s, const Vertex* t) const;
+
+    /**
+     * Removes a vertex with a given content or info (station2) to a graph (this), with every edge coming from or
+     * going to it, in both directions, and its segments.
+     *
+     * Complexity : O(V + dD), d being the degree of the vertex and D the largest degree of its neighbours
      * @param station2 Vertex to remove from graph
      * @return true if successful, and false if a vertex with that content doesn't exist.
      */
-    bool removeVertex(Station &station2);
+    bool removeVertex(const Station &station2);
 
     /**
      * Adds an edge to a graph (this), given the contents of the source and
@@ -41,7 +107,7 @@ public:
      * @param service Service provided by this segment of the train network
      * @return true if successful, and false if the source or destination vertex does not exist.
      */
-    bool addEdge(Station &sourc, Station &dest, int w , const string& service);
+    bool addEdge(const Station &sourc, const Station &dest, int w , const string& service);
 
     /**
      * Adds 2 edges to a graph (this), given the contents of the source and
@@ -50,9 +116,10 @@ public:
      * @param dest  Destination vertex which the edge point to
      * @param w Weight of the edge
      * @param service Service provided by this segment of the train network
-     * @return true if successful, and false if the source or destination vertex does not exist.
+     * @return true if successful, and false if the source or destination vertex does not exist or they are already
+     * connected by a segment, in either direction.
      */
-    bool addBidirectionalEdge(Station &sourc, Station &dest, int  w , const string& service);
+    bool addBidirectionalEdge(const Station &sourc, const Station &dest, int  w , const string& service);
 
     /**
      * @return returns the number of vertices
@@ -64,87 +131,61 @@ public:
      */
     std::vector<Vertex *> getVertexSet() const;
 
-    void testAndVisit(std::queue< Vertex*> &q, Edge *e, Vertex *w, double residual);
-
     /**
-     * Finds a path between node s and t, updating the values of path inside the nodes
+     * Removes the edge in a undirected graph which connects nodes s and t, found in the index of segments
      *
-     * Complexity : O(V+E) where V and E stands for the number of vertices and edges in the graph respectively.
-     * @param s The first node of the path, source node
-     * @param t The last node of the path, target node
-     * @return Returns true if successful, false if no path exists between node s and t
+     * Complexity : O(1) on average to find the segment, plus the degree of s and t to remove it
+     * @param s One of the nodes which the edges connects to
+     * @param t The other node which the edge connects to
+     * @return A pair whose first elements is true if there exists an edge between s and t, false otherwise, and the
+     * second element is a copy of the edge that connects s and t, in case it exists
      */
-    bool findAugmentingPath(Vertex *s, Vertex *t);
+    pair<bool,Edge> removeBidirectionalEdge(Vertex* s , Vertex* t);
 
     /**
-     * Goes through the path indicated by the path attribute inside vertex to find the minimum value of the
-     * residual(capacity - flow) of every vertex in the path.
-     *
-     * Complexity : O(V) where V is the number of vertices in the graph
-     * @param s The start of the path , source node
-     * @param t The end of the path , source node
-     * @return The minimum value of the residual between the nodes in the path
+     * @return A counter incremented every time a vertex or an edge is added or removed, used to know when copies
+     * of the topology (like CSRGraph) are out of date
      */
-    double findMinResidualAlongPath(Vertex *s, Vertex *t);
+    unsigned long getVersion() const;
 
     /**
-     * Goes through the path indicated by the path attribute inside vertex and adds to the values of flow of every
-     * vertex in that path the value f
-     *
-     * Complexity : O(V) where V is the number of vertices in the graph
-     * @param s The source node of the path
-     * @param t The target node of the path
-     * @param f The value to add to the flow of the nodes in the path
+     * @return The counters of the allocator of the vertices
      */
-    void augmentFlowAlongPath(Vertex *s, Vertex *t, double f);
+    const ObjectPool<Vertex>::Stats& getVertexPoolStats() const;
 
     /**
-     * Applies the algorithm Edmonds-Karp to find the maximum flow from node s to node t
-     *
-     * Complexity : O(VE^2)
-     * @param s Source node
-     * @param t Target node
-     * @return The maximum flow from s to t
+     * @return The counters of the allocator of the edges
      */
-    unsigned int edmondsKarp(Vertex* s , Vertex* t);
+    const ObjectPool<Edge>::Stats& getEdgePoolStats() const;
 
-    /**
-     * Removes the edge in a undirected graph which connects nodes s and t
-     * @param s One of the nodes which the edges connects to
-     * @param t The other node which the edge connects to
-     * @return A pair whose first elements is true if there exists an edge between s and t, false otherwise, and the
-     * second element is a copy of the edge that connects s and t, in case it exists
-     */
-    pair<bool,Edge> removeBidirectionalEdge(Vertex* s , Vertex* t);
-
-    /**
-     * Performs a Breath-First Search to find the leaf nodes of the tree with root node n of an MST graph considering
-     * every edge has the same weight 1.
-     *
-     * Complexity : O(V + E)
-     * @param n Root node
-     * @param v Empty vector which will contain the leaf nodes upon exiting
-     */
-    void BFS(Vertex *n, vector<Vertex*>& v);
 
+protected:
     /**
-     * Performs the prims algorithm
-     * @param s Source vertex
+     * Makes v the vertex found by the name of its station, unless another vertex already has that name.
      */
-    void prims(Vertex* s);
+    void indexVertex(Vertex* v);
 
     /**
-     * Finds the maximum flow after executing the prims algorithm
-     * @param s
-     * @param t
-     * @return
+     * Makes the name of the station of v, which is being removed, point to another vertex with the same name if
+     * there is one.
      */
-    unsigned long maxFlowAfterPrim(Vertex* s , Vertex*t);
-
+    void unindexVertex(Vertex* v);
 
+    // the edges are destroyed after the vertices, whose adjacency lists point to them
+    ObjectPool<Edge> edgePool;
+    ObjectPool<Vertex> vertexPool;
 
-protected:
     std::vector<Vertex *> vertexSet;    // vertex set
+    std::vector<Vertex *> vertexByName; // vertex of each station name, indexed by the name identifier
+    std::unordered_map<unsigned long long, Edge *> segments;  // one edge of each segment, see segmentKey
+
+    /**
+     * @return The key of the segment between s and t in segments, made of the identifiers of the vertices, smallest
+     * first, so that it does not depend on the direction. Stations with the same name have distinct keys.
+     */
+    static unsigned long long segmentKey(const Vertex* s, const Vertex* t);
+    unsigned long version = 0;          // topology version
+    unsigned int nextVertexId = 0;      // identifier of the next vertex added, see Vertex::getId
 
 
     double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
@@ -0,0 +1,121 @@
+#ifndef PROJECT_INDEXEDHEAP_H
+#define PROJECT_INDEXEDHEAP_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * Min-priority queue of vertex indexes with a decrease-key operation, as a D-ary heap.
+ *
+ * The position of every vertex in the heap is kept in an array indexed by vertex, so the heap holds at most one
+ * entry per vertex. Entries are ordered by key and then by vertex index, the same order as a std::priority_queue of
+ * (key, vertex) pairs, so replacing one by the other does not change the order in which vertices come out.
+ * The arrays are kept between uses, clearing the heap only touches the vertices still in it.
+ */
+template <typename Key, unsigned int D = 4>
+class IndexedHeap {
+public:
+    /**
+     * Makes room for vertices [0, n), emptying the heap if n changed.
+     *
+     * Complexity : O(1), or O(n) when n changed
+     */
+    void resize(int n) {
+        if ((int) position.size() == n) return;
+        position.assign(n, -1);
+        heap.clear();
+    }
+
+    /**
+     * Removes every vertex from the heap.
+     *
+     * Complexity : O(number of vertices in the heap)
+     */
+    void clear() {
+        for (const auto& entry : heap) {
+            position[entry.second] = -1;
+        }
+        heap.clear();
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    /**
+     * Adds vertex v with the given key, or decreases its key if it is already in the heap with a greater one.
+     *
+     * Complexity : O(log_D n)
+     */
+    void push(int v, Key key) {
+        int i = position[v];
+        if (i == -1) {
+            i = heap.size();
+            heap.emplace_back(key, v);
+        }
+        else if (key < heap[i].first) {
+            heap[i].first = key;
+        }
+        else {
+            return;
+        }
+        siftUp(i);
+    }
+
+    /**
+     * Removes the vertex with the smallest key.
+     *
+     * Complexity : O(D log_D n)
+     * @return The vertex removed
+     */
+    int pop() {
+        int v = heap.front().second;
+        position[v] = -1;
+        std::pair<Key, int> last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return v;
+    }
+
+private:
+    void siftUp(int i) {
+        std::pair<Key, int> entry = heap[i];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (!(entry < heap[p])) break;
+            place(i, heap[p]);
+            i = p;
+        }
+        place(i, entry);
+    }
+
+    void siftDown(int i) {
+        std::pair<Key, int> entry = heap[i];
+        int size = heap.size();
+        while (true) {
+            long first = (long) D * i + 1;
+            if (first >= size) break;
+            int best = first;
+            for (int c = first + 1; c < first + D && c < size; c++) {
+                if (heap[c] < heap[best]) best = c;
+            }
+            if (!(heap[best] < entry)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+
+    void place(int i, const std::pair<Key, int>& entry) {
+        heap[i] = entry;
+        position[entry.second] = i;
+    }
+
+    std::vector<std::pair<Key, int>> heap;
+    std::vector<int> position;      // index of every vertex in heap, -1 when it is not in it
+};
+
+#endif //PROJECT_INDEXEDHEAP_H
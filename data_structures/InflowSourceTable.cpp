@@ -0,0 +1,49 @@
+#include "InflowSourceTable.h"
+#include "Instrumentation.h"
+
+InflowSourceTable::InflowSourceTable(int numVertex) : begins(numVertex, -1), ends(numVertex, -1) {}
+
+InflowSourceTable::InflowSourceTable(const CSRGraph &network, ParallelFlowDriver &driver) {
+    TIME_PHASE(INFLOW_SOURCES);
+    int n = network.getNumVertex();
+    std::vector<std::vector<int>> found(n);
+    driver.run(n, [&](int t, FlowWorkspace& ws){
+        network.findInflowSources(ws, t, found[t]);
+    });
+
+    begins.resize(n);
+    ends.resize(n);
+    size_t total = 0;
+    for (const auto& s : found) {
+        total += s.size();
+    }
+    sources.reserve(total);
+    for (int t = 0; t < n; t++) {
+        begins[t] = sources.size();
+        sources.insert(sources.end(), found[t].begin(), found[t].end());
+        ends[t] = sources.size();
+    }
+}
+
+int InflowSourceTable::getNumVertex() const {
+    return begins.size();
+}
+
+bool InflowSourceTable::contains(int t) const {
+    return begins[t] != -1;
+}
+
+void InflowSourceTable::get(int t, std::vector<int> &result) const {
+    result.assign(sources.begin() + begins[t], sources.begin() + ends[t]);
+}
+
+void InflowSourceTable::find(const CSRGraph &network, FlowWorkspace &ws, int t, std::vector<int> &result) {
+    if (!contains(t)) {
+        network.findInflowSources(ws, t, result);
+        begins[t] = sources.size();
+        sources.insert(sources.end(), result.begin(), result.end());
+        ends[t] = sources.size();
+        return;
+    }
+    get(t, result);
+}
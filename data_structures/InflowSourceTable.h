@@ -0,0 +1,76 @@
+#ifndef PROJECT_INFLOWSOURCETABLE_H
+#define PROJECT_INFLOWSOURCETABLE_H
+
+#include <vector>
+
+#include "CSRGraph.h"
+#include "ParallelFlowDriver.h"
+
+/**
+ * Sources of the maximum flow arriving at the vertices of a network, as found by CSRGraph::findInflowSources, so
+ * that the flow arriving at a station can be computed without searching the leaves of its BFS every time.
+ *
+ * The table is either filled for every vertex at once, in parallel, for the callers that need all of them, or
+ * filled one vertex at a time, the first time the sources of that vertex are asked for. The sources are kept one
+ * after the other in a single array. The table describes the network it was built from and has to be built again
+ * when stations or segments are added or removed.
+ */
+class InflowSourceTable {
+public:
+    InflowSourceTable() = default;
+
+    /**
+     * Creates a table of a network without any sources, which find adds as they are asked for.
+     *
+     * Complexity : O(V)
+     * @param numVertex Number of vertices of the network
+     */
+    explicit InflowSourceTable(int numVertex);
+
+    /**
+     * Finds the sources of every vertex, the vertices being split between the threads of the driver.
+     *
+     * Complexity : O(V (V + E))
+     * @param network The network
+     * @param driver Threads that run the searches
+     */
+    InflowSourceTable(const CSRGraph& network, ParallelFlowDriver& driver);
+
+    /**
+     * @return returns the number of vertices
+     */
+    int getNumVertex() const;
+
+    /**
+     * @param t Index of a vertex
+     * @return true if the sources of t are in the table
+     */
+    bool contains(int t) const;
+
+    /**
+     * Complexity : O(number of sources)
+     * @param t Index of a vertex whose sources are in the table
+     * @param sources Vector that will contain the indexes of the sources of the flow arriving at t, empty if the
+     * flow is 0
+     */
+    void get(int t, std::vector<int>& sources) const;
+
+    /**
+     * Gets the sources of vertex t, finding them first and adding them to the table if they are not in it yet.
+     *
+     * Complexity : O(number of sources), O(V + E) the first time
+     * @param network The network the table describes
+     * @param ws Workspace used by the search
+     * @param t Index of a vertex
+     * @param sources Vector that will contain the indexes of the sources of the flow arriving at t, empty if the
+     * flow is 0
+     */
+    void find(const CSRGraph& network, FlowWorkspace& ws, int t, std::vector<int>& sources);
+
+private:
+    std::vector<int> begins;        // sources of vertex t are [begins[t], ends[t]), begins[t] is -1 until known
+    std::vector<int> ends;
+    std::vector<int> sources;
+};
+
+#endif //PROJECT_INFLOWSOURCETABLE_H
@@ -0,0 +1,159 @@
+#include "Instrumentation.h"
+#include <iomanip>
+
+#ifdef PROJECT_INSTRUMENTATION
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace Instrumentation {
+    namespace {
+        const char* const COUNTER_NAMES[] = {"bfs_runs", "bfs_vertices", "bfs_arcs", "augmentations",
+                                             "augmented_arcs", "prim_heap_pushes", "prim_heap_pops", "station_rows",
+                                             "network_rows", "cut_tree_flows", "pairs_done", "pairs_skipped"};
+        const char* const PHASE_NAMES[] = {"load_stations", "load_networks", "load_snapshot", "cut_tree",
+                                           "pair_flows", "inflow_sources", "failure_scenarios"};
+        static_assert(sizeof(COUNTER_NAMES) / sizeof(*COUNTER_NAMES) == (size_t) Counter::COUNT, "counter names");
+        static_assert(sizeof(PHASE_NAMES) / sizeof(*PHASE_NAMES) == (size_t) Phase::COUNT, "phase names");
+
+#ifdef PROJECT_INSTRUMENTATION
+        /**
+         * Counters of one thread. Only that thread writes them, other threads may read them at any time.
+         */
+        struct ThreadCounters {
+            ThreadCounters();
+            ~ThreadCounters();
+
+            void addTo(Totals& totals) const {
+                for (int i = 0; i < (int) Counter::COUNT; i++) {
+                    totals.counters[i] += counters[i].load(std::memory_order_relaxed);
+                }
+                for (int i = 0; i < (int) Phase::COUNT; i++) {
+                    totals.phaseCalls[i] += phaseCalls[i].load(std::memory_order_relaxed);
+                    totals.phaseNanos[i] += phaseNanos[i].load(std::memory_order_relaxed);
+                }
+            }
+
+            std::atomic<uint64_t> counters[(int) Counter::COUNT] = {};
+            std::atomic<uint64_t> phaseCalls[(int) Phase::COUNT] = {};
+            std::atomic<uint64_t> phaseNanos[(int) Phase::COUNT] = {};
+        };
+
+        /**
+         * Blocks of the threads alive, and the totals of the threads that ended.
+         */
+        struct Registry {
+            std::mutex lock;
+            std::vector<const ThreadCounters*> threads;
+            Totals retired;
+        };
+
+        Registry& registry() {
+            // never destroyed, threads may end after the static objects are destroyed
+            static Registry* r = new Registry();
+            return *r;
+        }
+
+        ThreadCounters::ThreadCounters() {
+            std::lock_guard<std::mutex> guard(registry().lock);
+            registry().threads.push_back(this);
+        }
+
+        ThreadCounters::~ThreadCounters() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            addTo(r.retired);
+            for (size_t i = 0; i < r.threads.size(); i++) {
+                if (r.threads[i] == this) {
+                    r.threads[i] = r.threads.back();
+                    r.threads.pop_back();
+                    break;
+                }
+            }
+        }
+
+        thread_local ThreadCounters local;
+
+        /**
+         * Adds n to a counter written only by the calling thread, without a locked instruction.
+         */
+        inline void increase(std::atomic<uint64_t>& counter, uint64_t n) {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+#endif
+    }
+
+#ifdef PROJECT_INSTRUMENTATION
+    void add(Counter counter, uint64_t n) {
+        increase(local.counters[(int) counter], n);
+    }
+
+    void addPhase(Phase phase, uint64_t nanos) {
+        increase(local.phaseCalls[(int) phase], 1);
+        increase(local.phaseNanos[(int) phase], nanos);
+    }
+#endif
+
+    Totals Totals::operator-(const Totals& earlier) const {
+        Totals res;
+        for (int i = 0; i < (int) Counter::COUNT; i++) {
+            res.counters[i] = counters[i] - earlier.counters[i];
+        }
+        for (int i = 0; i < (int) Phase::COUNT; i++) {
+            res.phaseCalls[i] = phaseCalls[i] - earlier.phaseCalls[i];
+            res.phaseNanos[i] = phaseNanos[i] - earlier.phaseNanos[i];
+        }
+        return res;
+    }
+
+    Totals snapshot() {
+        Totals totals;
+#ifdef PROJECT_INSTRUMENTATION
+        Registry& r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        totals = r.retired;
+        for (const ThreadCounters* t : r.threads) {
+            t->addTo(totals);
+        }
+#endif
+        return totals;
+    }
+
+    void writeJson(std::ostream& out, const Totals& totals, uint64_t runs) {
+        if (runs == 0) runs = 1;
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        // the counts are whole numbers unless they are averages
+        int countPrecision = runs == 1 ? 0 : 2;
+        out << std::fixed << std::setprecision(countPrecision);
+        out << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"counters\": {";
+        for (int i = 0; i < (int) Counter::COUNT; i++) {
+            out << (i == 0 ? "\"" : ", \"") << COUNTER_NAMES[i] << "\": " << (double) totals.counters[i] / runs;
+        }
+        out << "}, \"phases\": {";
+        for (int i = 0; i < (int) Phase::COUNT; i++) {
+            out << (i == 0 ? "\"" : ", \"") << PHASE_NAMES[i] << "\": {\"calls\": " << std::setprecision(countPrecision)
+                << (double) totals.phaseCalls[i] / runs << ", \"ms\": " << std::setprecision(3)
+                << totals.phaseNanos[i] / 1e6 / runs << "}";
+        }
+        // records per second of the time spent in the loader that read them
+        auto rate = [&](Counter counter, Phase phase) {
+            uint64_t nanos = totals.phaseNanos[(int) phase];
+            return nanos == 0 ? 0.0 : totals.counters[(int) counter] * 1e9 / nanos;
+        };
+        out << std::setprecision(0) << "}, \"rates\": {\"station_rows_per_second\": "
+            << rate(Counter::STATION_ROWS, Phase::LOAD_STATIONS) << ", \"network_rows_per_second\": "
+            << rate(Counter::NETWORK_ROWS, Phase::LOAD_NETWORKS) << "}}";
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    const char* getName(Counter counter) {
+        return COUNTER_NAMES[(int) counter];
+    }
+
+    const char* getName(Phase phase) {
+        return PHASE_NAMES[(int) phase];
+    }
+}
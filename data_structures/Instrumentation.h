@@ -0,0 +1,131 @@
+#ifndef PROJECT_INSTRUMENTATION_H
+#define PROJECT_INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Events counted by the algorithms when the program is built with instrumentation (see PROJECT_INSTRUMENTATION).
+ */
+enum class Counter : int {
+    BFS_RUNS,               // breadth-first searches for an augmenting path
+    BFS_VERTICES,           // vertices taken from their queue
+    BFS_ARCS,               // arcs scanned by them
+    AUGMENTATIONS,          // augmenting paths the flow was sent along
+    AUGMENTED_ARCS,         // arcs of those paths
+    PRIM_HEAP_PUSHES,       // insertions and decreased keys in the heap of prims
+    PRIM_HEAP_POPS,
+    STATION_ROWS,           // records read from the stations file
+    NETWORK_ROWS,           // records read from the network file
+    CUT_TREE_FLOWS,         // maximum flows computed to build a Gomory-Hu tree
+    PAIRS_DONE,             // pairs of stations whose flow was read from a Gomory-Hu tree
+    PAIRS_SKIPPED,          // pairs of stations on different lines, whose flow is 0
+    COUNT
+};
+
+/**
+ * Phases of the program whose calls and duration are measured when it is built with instrumentation.
+ */
+enum class Phase : int {
+    LOAD_STATIONS,
+    LOAD_NETWORKS,
+    LOAD_SNAPSHOT,
+    CUT_TREE,
+    PAIR_FLOWS,
+    INFLOW_SOURCES,
+    FAILURE_SCENARIOS,
+    COUNT
+};
+
+/**
+ * Low overhead counters and phase timers.
+ *
+ * Every thread counts in its own block of relaxed atomic integers, which only that thread writes, so counting
+ * never synchronizes with other threads. The blocks are registered when a thread first counts something and folded
+ * into a global total when it ends, so the totals include the worker threads of every ParallelFlowDriver::run.
+ * Without PROJECT_INSTRUMENTATION the macros COUNT_EVENTS and TIME_PHASE expand to nothing and the totals are
+ * always 0, so the algorithms pay nothing for them.
+ */
+namespace Instrumentation {
+#ifdef PROJECT_INSTRUMENTATION
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    /**
+     * Sums of the counters and phases of every thread.
+     */
+    struct Totals {
+        uint64_t counters[(int) Counter::COUNT] = {};
+        uint64_t phaseCalls[(int) Phase::COUNT] = {};
+        uint64_t phaseNanos[(int) Phase::COUNT] = {};
+
+        /**
+         * @return What was counted between two snapshots, this being the later one
+         */
+        Totals operator-(const Totals& earlier) const;
+    };
+
+    /**
+     * Complexity : O(number of threads that counted something)
+     * @return The totals counted since the program started
+     */
+    Totals snapshot();
+
+    /**
+     * Writes totals as a JSON object on a single line: the counters and phases by name, each phase with its number
+     * of calls and total milliseconds, and the rows read per second by the loaders. With runs greater than 1 the
+     * counts are averages over that many runs.
+     * @param out Stream the object is written to
+     * @param totals The totals, usually the difference of two snapshots
+     * @param runs Number of runs the totals are divided by
+     */
+    void writeJson(std::ostream& out, const Totals& totals, uint64_t runs = 1);
+
+    const char* getName(Counter counter);
+    const char* getName(Phase phase);
+
+#ifdef PROJECT_INSTRUMENTATION
+    /**
+     * Adds n to a counter of the calling thread.
+     */
+    void add(Counter counter, uint64_t n);
+
+    /**
+     * Adds a call of a phase, and its duration, to the calling thread.
+     */
+    void addPhase(Phase phase, uint64_t nanos);
+
+    /**
+     * Measures a phase from its construction to its destruction.
+     */
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(Phase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+        ~PhaseTimer() {
+            auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            addPhase(phase, nanos.count());
+        }
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+#endif
+}
+
+#ifdef PROJECT_INSTRUMENTATION
+#define COUNT_EVENTS(counter, n) Instrumentation::add(Counter::counter, (n))
+#define TIME_PHASE_CONCAT(a, b) a##b
+#define TIME_PHASE_NAME(line) TIME_PHASE_CONCAT(phaseTimer, line)
+#define TIME_PHASE(phase) Instrumentation::PhaseTimer TIME_PHASE_NAME(__LINE__)(Phase::phase)
+#else
+#define COUNT_EVENTS(counter, n) ((void) 0)
+#define TIME_PHASE(phase) ((void) 0)
+#endif
+
+#endif //PROJECT_INSTRUMENTATION_H
@@ -0,0 +1,144 @@
+#ifndef PROJECT_OBJECTPOOL_H
+#define PROJECT_OBJECTPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Slab allocator for objects of type T.
+ *
+ * Objects are constructed in slots of large blocks (slabs) allocated from the heap one at a time. Destroyed
+ * objects leave their slot in a free list that is used before any new slot, so a structure that keeps adding and
+ * removing objects stops allocating memory once it has enough slots. Every object still alive is destroyed when
+ * the pool is cleared or destroyed, which for trivially destructible types only frees the slabs.
+ * Objects never move, pointers to them stay valid until they are destroyed.
+ */
+template <typename T>
+class ObjectPool {
+public:
+    /**
+     * Counters of the pool, to check for example that a workload does not allocate memory.
+     */
+    struct Stats {
+        size_t slabAllocations = 0;     // heap allocations made by the pool since it was created
+        size_t slots = 0;               // slots in the slabs currently held
+        size_t live = 0;                // objects currently alive
+        size_t created = 0;             // objects created since the pool was created
+        size_t reused = 0;              // objects created in a slot taken from the free list
+    };
+
+    /**
+     * @param slabSize Number of objects in every slab
+     */
+    explicit ObjectPool(size_t slabSize = 256) : slabSize(slabSize) {}
+
+    ~ObjectPool() {
+        clear();
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * Constructs an object in a free slot, allocating a new slab only if there are none.
+     *
+     * Complexity : O(1)
+     * @param args Arguments of the constructor of T
+     * @return The new object
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = takeSlot();
+        try {
+            new (slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            slot->alive = false;
+            slot->next = freeList;
+            freeList = slot;
+            throw;
+        }
+        slot->alive = true;
+        stats.created++;
+        stats.live++;
+        return reinterpret_cast<T*>(slot->storage);
+    }
+
+    /**
+     * Destroys an object created by this pool and keeps its slot for the next object.
+     *
+     * Complexity : O(1)
+     * @param object The object
+     */
+    void destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->alive = false;
+        slot->next = freeList;
+        freeList = slot;
+        stats.live--;
+    }
+
+    /**
+     * Destroys every object still alive and frees all the slabs.
+     *
+     * Complexity : O(number of slabs) for trivially destructible types, O(number of slots) otherwise
+     */
+    void clear() {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (size_t s = 0; s < slabs.size(); s++) {
+                size_t used = s + 1 == slabs.size() ? usedInLastSlab : slabSize;
+                for (size_t i = 0; i < used; i++) {
+                    if (slabs[s][i].alive) reinterpret_cast<T*>(slabs[s][i].storage)->~T();
+                }
+            }
+        }
+        slabs.clear();
+        freeList = nullptr;
+        usedInLastSlab = 0;
+        stats.slots = 0;
+        stats.live = 0;
+    }
+
+    /**
+     * @return The counters of the pool
+     */
+    const Stats& getStats() const {
+        return stats;
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];    // first, so that an object and its slot share the address
+        Slot* next;
+        bool alive;
+    };
+
+    Slot* takeSlot() {
+        if (freeList != nullptr) {
+            Slot* slot = freeList;
+            freeList = slot->next;
+            stats.reused++;
+            return slot;
+        }
+        if (slabs.empty() || usedInLastSlab == slabSize) {
+            slabs.push_back(std::make_unique<Slot[]>(slabSize));
+            usedInLastSlab = 0;
+            stats.slabAllocations++;
+            stats.slots += slabSize;
+        }
+        return &slabs.back()[usedInLastSlab++];
+    }
+
+    size_t slabSize;
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    size_t usedInLastSlab = 0;
+    Slot* freeList = nullptr;
+    Stats stats;
+};
+
+#endif //PROJECT_OBJECTPOOL_H
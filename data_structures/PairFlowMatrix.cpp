@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "PairFlowMatrix.h"
+#include "Instrumentation.h"
+
+PairFlowMatrix::PairFlowMatrix(const CSRGraph &network, const GomoryHuTree &tree, ParallelFlowDriver &driver) {
+    TIME_PHASE(PAIR_FLOWS);
+    numVertex = network.getNumVertex();
+    int n = numVertex;
+    flows.assign((long) n * (n - 1) / 2, 0);
+    if (n < 2) return;
+
+    // a few rows per task, so that the flows vector of a task is reused by all of its rows
+    int blocks = std::min<int>(n, 16 * driver.getNumThreads());
+    driver.run(blocks, [&](int b, FlowWorkspace&){
+        std::vector<unsigned long> row;
+        long done = 0, skipped = 0;
+        for (int i = (long) n * b / blocks; i < (long) n * (b + 1) / blocks; i++) {
+            tree.flowsFrom(i, row);
+            long p = position(i, i + 1);
+            for (int j = i + 1; j < n; j++, p++) {
+                bool sameLine = network.getLine(i) == network.getLine(j);
+                flows[p] = sameLine ? row[j] : 0;
+                if (sameLine) done++;
+                else skipped++;
+            }
+        }
+        COUNT_EVENTS(PAIRS_DONE, done);
+        COUNT_EVENTS(PAIRS_SKIPPED, skipped);
+    });
+}
+
+int PairFlowMatrix::getNumVertex() const {
+    return numVertex;
+}
+
+unsigned long PairFlowMatrix::get(int i, int j) const {
+    if (i == j) return 0;
+    if (i > j) std::swap(i, j);
+    return flows[position(i, j)];
+}
+
+long PairFlowMatrix::position(int i, int j) const {
+    // rows 0..i-1 hold n-1, n-2, ..., n-i pairs
+    return (long) i * (2L * numVertex - i - 1) / 2 + (j - i - 1);
+}
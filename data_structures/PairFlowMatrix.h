@@ -0,0 +1,56 @@
+#ifndef PROJECT_PAIRFLOWMATRIX_H
+#define PROJECT_PAIRFLOWMATRIX_H
+
+#include <vector>
+
+#include "CSRGraph.h"
+#include "GomoryHuTree.h"
+#include "ParallelFlowDriver.h"
+
+/**
+ * Maximum flow between every pair of vertices of a network, stored once so that every report over the pairs of
+ * stations can read it instead of computing the flows again.
+ *
+ * Only the pairs i < j are kept, row after row in a single array, since the flow is the same in both directions.
+ * Stations on different lines have a flow of 0, like in CSRGraph::maxFlow.
+ * Vertices are identified by their index in the CSRGraph the matrix was built from.
+ */
+class PairFlowMatrix {
+public:
+    PairFlowMatrix() = default;
+
+    /**
+     * Fills the matrix with the flows read from the Gomory-Hu tree of the network, one row per vertex, the rows
+     * being split between the threads of the driver.
+     *
+     * Complexity : O(V^2)
+     * @param network The network
+     * @param tree The Gomory-Hu tree of the network
+     * @param driver Threads that fill the rows
+     */
+    PairFlowMatrix(const CSRGraph& network, const GomoryHuTree& tree, ParallelFlowDriver& driver);
+
+    /**
+     * @return returns the number of vertices
+     */
+    int getNumVertex() const;
+
+    /**
+     * Complexity : O(1)
+     * @param i Index of a vertex
+     * @param j Index of a vertex
+     * @return The maximum flow between i and j, 0 if i == j
+     */
+    unsigned long get(int i, int j) const;
+
+private:
+    /**
+     * @return The position of the pair i < j in flows
+     */
+    long position(int i, int j) const;
+
+    int numVertex = 0;
+    std::vector<unsigned long> flows;
+};
+
+#endif //PROJECT_PAIRFLOWMATRIX_H
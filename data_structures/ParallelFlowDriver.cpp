@@ -0,0 +1,89 @@
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <exception>
+#include <atomic>
+#include "ParallelFlowDriver.h"
+
+namespace {
+    struct TaskRange {
+        std::mutex lock;
+        int begin = 0;
+        int end = 0;
+    };
+}
+
+ParallelFlowDriver::ParallelFlowDriver(unsigned int threads) {
+    numThreads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    workspaces.resize(numThreads);
+}
+
+unsigned int ParallelFlowDriver::getNumThreads() const {
+    return numThreads;
+}
+
+void ParallelFlowDriver::run(int count, const std::function<void(int, FlowWorkspace &)> &task) {
+    int workers = std::min<int>(numThreads, count);
+    if (workers <= 1) {
+        for (int i = 0; i < count; i++) {
+            task(i, workspaces[0]);
+        }
+        return;
+    }
+
+    std::unique_ptr<TaskRange[]> ranges(new TaskRange[workers]);
+    for (int w = 0; w < workers; w++) {
+        ranges[w].begin = (long) count * w / workers;
+        ranges[w].end = (long) count * (w + 1) / workers;
+    }
+
+    std::mutex errorLock;
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+
+    auto next = [&](int w) {
+        {
+            std::lock_guard<std::mutex> guard(ranges[w].lock);
+            if (ranges[w].begin < ranges[w].end) return ranges[w].begin++;
+        }
+        for (int k = 1; k < workers; k++) {
+            TaskRange& victim = ranges[(w + k) % workers];
+            int begin, end;
+            {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (victim.begin >= victim.end) continue;
+                begin = victim.begin + (victim.end - victim.begin) / 2;
+                end = victim.end;
+                victim.end = begin;
+            }
+            std::lock_guard<std::mutex> guard(ranges[w].lock);
+            ranges[w].begin = begin + 1;
+            ranges[w].end = end;
+            return begin;
+        }
+        return -1;
+    };
+
+    auto work = [&](int w) {
+        for (int i = next(w); i != -1; i = next(w)) {
+            if (failed) return;
+            try {
+                task(i, workspaces[w]);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!failed) error = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++) {
+        threads.emplace_back(work, w);
+    }
+    work(0);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
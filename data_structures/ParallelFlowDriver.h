@@ -0,0 +1,44 @@
+#ifndef PROJECT_PARALLELFLOWDRIVER_H
+#define PROJECT_PARALLELFLOWDRIVER_H
+
+#include <functional>
+#include <vector>
+
+#include "FlowWorkspace.h"
+
+/**
+ * Runs independent flow tasks on a pool of worker threads.
+ *
+ * Every worker owns a FlowWorkspace, so tasks can run algorithms on a shared CSRGraph at the same time. The tasks
+ * are split in contiguous ranges, one per worker, and a worker that runs out of tasks steals half of the remaining
+ * range of another one, which keeps every thread busy when tasks take very different times.
+ * Tasks should write their results to separate slots, to be merged in order by the caller once run returns, so
+ * that the final result does not depend on how the tasks were scheduled.
+ */
+class ParallelFlowDriver {
+public:
+    /**
+     * @param threads Number of worker threads, 0 to use one per hardware thread
+     */
+    explicit ParallelFlowDriver(unsigned int threads = 0);
+
+    /**
+     * @return returns the number of worker threads
+     */
+    unsigned int getNumThreads() const;
+
+    /**
+     * Calls task(i, workspace) for every i in [0, count) and waits for all of them to finish.
+     * If a task throws, the exception is rethrown here after the other workers stopped.
+     *
+     * @param count Number of tasks
+     * @param task Function to call for every task, with the workspace of the worker running it
+     */
+    void run(int count, const std::function<void(int, FlowWorkspace&)>& task);
+
+private:
+    unsigned int numThreads;
+    std::vector<FlowWorkspace> workspaces;  // kept between runs so that they are only allocated once
+};
+
+#endif //PROJECT_PARALLELFLOWDRIVER_H
@@ -0,0 +1,24 @@
+#include "StringPool.h"
+
+unsigned int StringPool::intern(std::string_view s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) return it->second;
+    strings.emplace_back(s);
+    unsigned int id = strings.size() - 1;
+    ids.emplace(strings.back(), id);
+    return id;
+}
+
+unsigned int StringPool::find(std::string_view s) const {
+    auto it = ids.find(s);
+    if (it == ids.end()) return NONE;
+    return it->second;
+}
+
+const std::string &StringPool::get(unsigned int id) const {
+    return strings[id];
+}
+
+unsigned int StringPool::size() const {
+    return strings.size();
+}
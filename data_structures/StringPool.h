@@ -0,0 +1,52 @@
+#ifndef PROJECT_STRINGPOOL_H
+#define PROJECT_STRINGPOOL_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Set of distinct strings, each one identified by a dense integer given in order of first insertion.
+ *
+ * Objects that repeat the same strings many times can keep their identifiers instead, comparing and hashing them
+ * as integers. The strings are never moved once inserted, so the references returned by get stay valid for the
+ * lifetime of the pool.
+ */
+class StringPool {
+public:
+    static const unsigned int NONE = ~0u;
+
+    /**
+     * Inserts a string if it is not in the pool yet.
+     *
+     * Complexity : O(n) on average, n being the length of the string
+     * @param s The string
+     * @return The identifier of the string
+     */
+    unsigned int intern(std::string_view s);
+
+    /**
+     * Complexity : O(n) on average, n being the length of the string
+     * @param s The string
+     * @return The identifier of the string, or NONE if it is not in the pool
+     */
+    unsigned int find(std::string_view s) const;
+
+    /**
+     * @param id Identifier of a string of the pool
+     * @return The string
+     */
+    const std::string& get(unsigned int id) const;
+
+    /**
+     * @return returns the number of strings, every identifier being smaller than it
+     */
+    unsigned int size() const;
+
+private:
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, unsigned int> ids;    // views of the strings of the deque
+};
+
+#endif //PROJECT_STRINGPOOL_H
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include "../src/Station.h"
 #include "../src/Network.h"
+#include "../src/Service.h"
+#include "ObjectPool.h"
 
 class Edge;
 
@@ -16,41 +18,29 @@ class Edge;
 /************************* Vertex  **************************/
 
 class Vertex {
+    friend class Graph;
 public:
-    Vertex(Station station1);
-    bool operator<(Vertex & vertex) const;
+    Vertex(const Station& station1, ObjectPool<Edge>* edgePool = nullptr, unsigned int id = 0);
 
-    Station getStation() const;
+    const Station& getStation() const;
+    unsigned int getId() const;
     std::vector<Edge *> getAdj() const;
-    bool isVisited() const;
-    bool isProcessing() const;
-    unsigned int getIndegree() const;
-    double getDist() const;
-    Edge *getPath() const;
     std::vector<Edge *> getIncoming() const;
 
-    void setStation(Station station2);
-    void setVisited(bool visited);
-    void setProcesssing(bool processing);
-    void setIndegree(unsigned int indegree);
-    void setDist(double dist);
-    void setPath(Edge *path);
+    void setStation(const Station& station2);
     Edge * addEdge(Vertex *dest, int  w, const string& service);
-    bool removeEdge(Station destStation);
-    void removeAllEdges();
 protected:
+    // only Graph removes edges, since it also has to remove them from its segment index
+    void removeEdge(Edge* edge);
+    void destroyEdge(Edge* edge);
+
     Station station;
+    unsigned int id;                // unique in its graph, never given to another vertex
     std::vector<Edge *> adj;
 
-    bool visited = false;
-    bool processing = false;
-    unsigned int indegree;
-    double dist = 0;
-    Edge *path = nullptr;
-
     std::vector<Edge *> incoming;
 
-    int queueIndex = 0;
+    ObjectPool<Edge>* edgePool;     // where the edges are created, nullptr to use new and delete
 };
 
 /********************** Edge  ****************************/
@@ -61,28 +51,21 @@ public:
 
     Vertex * getDest() const;
     int getWeight() const;
-    string getService() const;
-    bool isSelected() const;
+    const string& getService() const;
+    unsigned int getServiceId() const;
     Vertex * getOrig() const;
     Edge *getReverse() const;
-    double getFlow() const;
 
-    void setSelected(bool selected);
     void setReverse(Edge *reverse);
-    void setFlow(double flow);
+    void setWeight(int weight);
 protected:
     Vertex * dest; // destination vertex
     int weight; // edge weight, can also be used for capacity
-    string service; // assim é mais facil
-
-    // auxiliary fields
-    bool selected = false;
+    Service service;
 
     // used for bidirectional edges
     Vertex *orig;
     Edge *reverse = nullptr;
-
-    double flow; // for flow-related problems
 };
 
 #endif //PROJECT_VERTEXEDGE_H
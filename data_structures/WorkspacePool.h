@@ -0,0 +1,93 @@
+#ifndef PROJECT_WORKSPACEPOOL_H
+#define PROJECT_WORKSPACEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "FlowWorkspace.h"
+
+/**
+ * FlowWorkspaces lent to the threads that run queries on a shared CSRGraph, such as the clients of a server.
+ *
+ * A thread takes a workspace for as long as it needs it and gives it back when the lease is destroyed, so that the
+ * next thread reuses its arrays, already sized for the graph, instead of allocating new ones. The pool only grows
+ * to the number of workspaces used at the same time.
+ */
+class WorkspacePool {
+public:
+    /**
+     * A workspace taken from the pool, given back when the lease is destroyed.
+     */
+    class Lease {
+    public:
+        Lease(WorkspacePool& pool, std::unique_ptr<FlowWorkspace> ws) : pool(&pool), ws(std::move(ws)) {}
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() {
+            if (ws != nullptr) pool->release(std::move(ws));
+        }
+
+        FlowWorkspace& operator*() const {
+            return *ws;
+        }
+
+        FlowWorkspace* operator->() const {
+            return ws.get();
+        }
+
+    private:
+        WorkspacePool* pool;
+        std::unique_ptr<FlowWorkspace> ws;
+    };
+
+    /**
+     * Counters of the pool, to check that workspaces are reused.
+     */
+    struct Stats {
+        size_t created = 0;     // workspaces created since the pool was created
+        size_t leases = 0;      // workspaces taken since the pool was created
+        size_t idle = 0;        // workspaces currently in the pool
+    };
+
+    /**
+     * Takes an idle workspace, or creates one if every workspace is in use.
+     *
+     * Complexity : O(1)
+     * @return The lease of the workspace
+     */
+    Lease acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.leases++;
+        if (idle.empty()) {
+            stats.created++;
+            return Lease(*this, std::make_unique<FlowWorkspace>());
+        }
+        std::unique_ptr<FlowWorkspace> ws = std::move(idle.back());
+        idle.pop_back();
+        return Lease(*this, std::move(ws));
+    }
+
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats res = stats;
+        res.idle = idle.size();
+        return res;
+    }
+
+private:
+    void release(std::unique_ptr<FlowWorkspace> ws) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(std::move(ws));
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<FlowWorkspace>> idle;
+    Stats stats;
+};
+
+#endif //PROJECT_WORKSPACEPOOL_H
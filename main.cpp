@@ -1,9 +1,30 @@
 #include <iostream>
+#include <fstream>
+#include <cstring>
 #include "src/TrainManager.h"
+#include "src/QueryServer.h"
 
 using namespace std;
-int main() {
+int main(int argc, char* argv[]) {
     TrainManager h;
+    // project --batch <file>, or - to read the queries from the standard input
+    if (argc == 3 && strcmp(argv[1], "--batch") == 0) {
+        if (strcmp(argv[2], "-") == 0) return h.runBatch(cin, cout) == 0 ? 0 : 1;
+        ifstream queries(argv[2]);
+        if (!queries) {
+            cerr << "Could not open the file " << argv[2] << "!\n";
+            return 1;
+        }
+        return h.runBatch(queries, cout) == 0 ? 0 : 1;
+    }
+    // project --serve <port or path of a Unix domain socket>
+    if (argc == 3 && strcmp(argv[1], "--serve") == 0) {
+        QueryServer server(h);
+        if (!server.listen(argv[2])) return 1;
+        cerr << "Answering queries on " << argv[2] << "\n";
+        server.run();
+        return 1;
+    }
     string check;
     while(true){
         cout << "==========================================================================================\n"
@@ -16,7 +37,9 @@ int main() {
                 <<"| 6- Calculate the maximum amount of trains that can simultaneously travel between two   |\n"
                 <<"|    given stations with minimum cost for the company.                                   |\n"
                 <<"| 7- Use a network of reduced connectivity.                                              |\n"
-                <<"| 8- Exit                                                                                |\n"
+                <<"| 8- Choose the algorithm used to calculate maximum flows.                               |\n"
+                <<"| 9- Compare the execution time of the maximum flow algorithms.                          |\n"
+                <<"| 10- Exit                                                                               |\n"
                 <<"==========================================================================================\n";
         int option;
         cin >> option;
@@ -45,7 +68,9 @@ int main() {
             case 5: h.calculateMaxFlowFromNetworkToSingleStation(); break;
             case 6: h.calculateMaxFlowWithMinimumCost();break;
             case 7: h.useSubGraph();break;
-            case 8: return 0;
+            case 8: h.chooseFlowEngine(); break;
+            case 9: h.benchmarkFlowEngines(); break;
+            case 10: return 0;
             default: cout <<"INVALID INPUT\n"; break;
         }
     }
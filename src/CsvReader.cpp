@@ -0,0 +1,138 @@
+#include "CsvReader.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+CsvReader::~CsvReader() {
+    close();
+}
+
+bool CsvReader::open(const string &path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size > 0) {
+        void* mappedData = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mappedData != MAP_FAILED) {
+            madvise(mappedData, info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mappedData);
+            size = info.st_size;
+            mapped = true;
+        }
+    }
+    if (!mapped) {
+        // not a regular file, read it whole
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        data = buffer.data();
+        size = buffer.size();
+    }
+    ::close(fd);
+    return true;
+}
+
+void CsvReader::close() {
+    if (mapped) munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    pos = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+size_t CsvReader::getSize() const {
+    return size;
+}
+
+bool CsvReader::readRecord(vector<string_view> &fields) {
+    // a line break ends a field, unless it is a CR that is not followed by LF
+    auto atDelimiter = [&](size_t p) {
+        if (p >= size) return true;
+        char c = data[p];
+        return c == ',' || c == '\n' || (c == '\r' && (p + 1 == size || data[p + 1] == '\n'));
+    };
+
+    while (pos < size && (data[pos] == '\n' || data[pos] == '\r')) pos++;
+    if (pos >= size) return false;
+
+    spans.clear();
+    unescaped.clear();
+    while (true) {
+        if (data[pos] == '"') {
+            pos++;
+            spans.push_back(readQuoted());
+        }
+        else {
+            size_t start = pos;
+            while (!atDelimiter(pos)) pos++;
+            spans.push_back({false, start, pos - start});
+        }
+        if (pos < size && data[pos] == ',') {
+            pos++;
+            if (pos >= size) {
+                spans.push_back({false, pos, 0});
+                break;
+            }
+            continue;
+        }
+        if (pos < size && data[pos] == '\r') pos++;
+        if (pos < size && data[pos] == '\n') pos++;
+        break;
+    }
+
+    fields.clear();
+    for (const Span& s : spans) {
+        const char* base = s.unescaped ? unescaped.data() : data;
+        fields.emplace_back(base + s.begin, s.length);
+    }
+    return true;
+}
+
+CsvReader::Span CsvReader::readQuoted() {
+    size_t start = pos;
+    // usual case, no doubled quotes: the field is a view of the file
+    while (pos < size && data[pos] != '"') pos++;
+    size_t end = pos;
+    if (pos >= size) return {false, start, end - start};
+    pos++;
+    if (pos >= size || data[pos] == ',' || data[pos] == '\n' || data[pos] == '\r') {
+        return {false, start, end - start};
+    }
+
+    // doubled quotes or text after the closing quote, the field is copied without them
+    size_t begin = unescaped.size();
+    unescaped.append(data + start, end - start);
+    bool quoted = data[pos] == '"';
+    if (quoted) {
+        unescaped += '"';
+        pos++;
+    }
+    while (pos < size) {
+        char c = data[pos];
+        if (quoted) {
+            if (c != '"') unescaped += c;
+            else if (pos + 1 < size && data[pos + 1] == '"') {
+                unescaped += '"';
+                pos++;
+            }
+            else quoted = false;
+        }
+        else {
+            if (c == ',' || c == '\n' || c == '\r') break;
+            if (c == '"') quoted = true;
+            else unescaped += c;
+        }
+        pos++;
+    }
+    return {true, begin, unescaped.size() - begin};
+}
@@ -0,0 +1,74 @@
+#ifndef PROJECT_CSVREADER_H
+#define PROJECT_CSVREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Streaming reader of CSV files as described by RFC 4180.
+ *
+ * The file is mapped into memory (or read into a single buffer when it can not be mapped) and the fields of each
+ * record are returned as views of that memory, so reading a field allocates nothing. Fields may be quoted, quoted
+ * fields may contain commas, line breaks and doubled quotes; only the fields with doubled quotes are copied, to a
+ * buffer reused by every record. Records may end with LF or CRLF, empty lines are skipped.
+ */
+class CsvReader {
+public:
+    CsvReader() = default;
+    ~CsvReader();
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    /**
+     * Opens a file, closing the previous one.
+     * Time complexity: O(1) when the file can be mapped, O(n) otherwise, n being the size of the file.
+     * @param path Path of the file
+     * @return true if the file could be opened
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Releases the file, the views returned before can no longer be used.
+     */
+    void close();
+
+    /**
+     * Reads the next record of the file.
+     * Time complexity: O(n), n being the length of the record.
+     * @param fields Vector that will contain the fields of the record, valid until the next call
+     * @return false if there are no more records
+     */
+    bool readRecord(std::vector<std::string_view>& fields);
+
+    /**
+     * @return The size of the file in bytes
+     */
+    size_t getSize() const;
+
+private:
+    /**
+     * Part of a record that is either in the file or in the buffer of unescaped fields.
+     */
+    struct Span {
+        bool unescaped;
+        size_t begin;
+        size_t length;
+    };
+
+    /**
+     * Reads a quoted field, pos being right after its opening quote, up to the character after the closing quote
+     * and whatever follows it before the next delimiter.
+     */
+    Span readQuoted();
+
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+    bool mapped = false;
+    std::vector<char> buffer;       // contents of the file when it could not be mapped
+    std::string unescaped;          // fields of the current record with doubled quotes, without them
+    std::vector<Span> spans;
+};
+
+#endif //PROJECT_CSVREADER_H
@@ -0,0 +1,103 @@
+#include "NetworkGenerator.h"
+#include <fstream>
+#include <unordered_set>
+#include <vector>
+using namespace std;
+
+NetworkGenerator::NetworkGenerator(const Parameters& parameters) : parameters(parameters) {}
+
+string NetworkGenerator::validate() const {
+    const Parameters& p = parameters;
+    if (p.lines < 1) return "there must be at least one line";
+    if (p.stations < p.lines) return "every line needs at least one station";
+    for (double probability : {p.branching, p.express, p.interchanges}) {
+        if (!(probability >= 0 && probability <= 1)) return "probabilities must be between 0 and 1";
+    }
+    if (p.minCapacity < 1 || p.maxCapacity < p.minCapacity) return "invalid capacity range";
+    if (p.stationsPerMunicipality < 1 || p.districts < 1) return "invalid number of municipalities or districts";
+    return "";
+}
+
+long NetworkGenerator::write(const string& stationsFile, const string& networkFile) const {
+    const Parameters& p = parameters;
+    auto first = [&](int line){ return (int) ((long long) line * p.stations / p.lines); };
+    auto name = [](int i){ return "Station " + to_string(i); };
+
+    ofstream stations(stationsFile);
+    stations << "Name,District,Municipality,Township,Line\n";
+    long long municipalities = (p.stations + p.stationsPerMunicipality - 1) / p.stationsPerMunicipality;
+    for (int line = 0; line < p.lines; line++) {
+        for (int i = first(line); i < first(line + 1); i++) {
+            long long municipality = i / p.stationsPerMunicipality;
+            stations << name(i) << ",DISTRICT " << municipality * p.districts / municipalities << ",MUNICIPALITY "
+                     << municipality << ",Township " << i / 5 << ",Line " << line << '\n';
+        }
+    }
+    stations.close();
+    if (!stations) return -1;
+
+    mt19937_64 rng(p.seed);
+    ofstream network(networkFile);
+    network << "Station_A,Station_B,Capacity,Service\n";
+    long segments = 0;
+    unordered_set<uint64_t> written;
+    auto addSegment = [&](int a, int b, const char* service){
+        uint64_t key = (uint64_t) min(a, b) * p.stations + max(a, b);
+        if (a == b || !written.insert(key).second) return;
+        network << name(a) << ',' << name(b) << ',' << capacity(rng) << ',' << service << '\n';
+        segments++;
+    };
+
+    vector<int> parent(p.stations, -1);
+    for (int line = 0; line < p.lines; line++) {
+        int begin = first(line), end = first(line + 1);
+        if (line > 0) {
+            // the lines are joined in a chain, so the network is connected
+            addSegment(begin, first(line - 1) + (int) uniform(rng, begin - first(line - 1)), "STANDARD");
+        }
+        for (int i = begin + 1; i < end; i++) {
+            bool branch = i - begin >= 2 && uniformReal(rng) < p.branching;
+            parent[i] = branch ? begin + (int) uniform(rng, i - begin - 1) : i - 1;
+            addSegment(parent[i], i, "STANDARD");
+        }
+        for (int i = begin; i < end; i++) {
+            if (uniformReal(rng) < p.express) {
+                int stops = 2 + (int) uniform(rng, 4), a = i, steps = 0;
+                while (steps < stops && parent[a] != -1) {
+                    a = parent[a];
+                    steps++;
+                }
+                if (steps >= 2) addSegment(a, i, "ALFA PENDULAR");
+            }
+            if (p.lines > 1 && uniformReal(rng) < p.interchanges) {
+                int other = (int) uniform(rng, p.lines - 1);
+                if (other >= line) other++;
+                addSegment(i, first(other) + (int) uniform(rng, first(other + 1) - first(other)), "STANDARD");
+            }
+        }
+    }
+    network.close();
+    if (!network) return -1;
+    return segments;
+}
+
+uint64_t NetworkGenerator::uniform(mt19937_64& rng, uint64_t n) {
+    // the numbers above the last multiple of n are drawn again, so that every remainder is equally likely
+    uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+    uint64_t x;
+    do {
+        x = rng();
+    } while (x >= limit);
+    return x % n;
+}
+
+double NetworkGenerator::uniformReal(mt19937_64& rng) {
+    return (double) (rng() >> 11) * 0x1.0p-53;
+}
+
+int NetworkGenerator::capacity(mt19937_64& rng) const {
+    double u = uniformReal(rng);
+    if (parameters.skewedCapacity) u *= u;
+    int range = parameters.maxCapacity - parameters.minCapacity + 1;
+    return parameters.minCapacity + min(range - 1, (int) (u * range));
+}
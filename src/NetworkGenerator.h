@@ -0,0 +1,71 @@
+#ifndef PROJECT_NETWORKGENERATOR_H
+#define PROJECT_NETWORKGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+/**
+ * Generates synthetic train networks, in the format of the stations and network CSV files, to test the loaders and
+ * the algorithms on networks much larger than the ones in the resources directory.
+ *
+ * Every line is a tree of stations: each new station continues the line from the previous one or, now and then,
+ * starts a branch from an earlier station of the line. Some stations also get an ALFA PENDULAR segment to a station
+ * a few stops back along their line (an express), and some an interchange segment to a station of another line. The
+ * first station of every line is joined to the previous line, so the whole network is connected. Consecutive
+ * stations share a municipality, and consecutive municipalities a district.
+ *
+ * The numbers are drawn from a std::mt19937_64, whose sequence is fixed by the standard, and mapped to ranges by the
+ * generator itself rather than by the standard distributions, whose results depend on the library. The same
+ * parameters therefore always give the same files, whatever the platform.
+ */
+class NetworkGenerator {
+public:
+    struct Parameters {
+        int stations = 1000;
+        int lines = 10;
+        double branching = 0.05;        // probability that a station starts a branch of its line
+        double express = 0.1;           // probability that a station has an ALFA PENDULAR segment
+        double interchanges = 0.02;     // probability that a station has a segment to another line
+        int minCapacity = 2;
+        int maxCapacity = 20;
+        bool skewedCapacity = false;    // small capacities are more likely than large ones
+        int stationsPerMunicipality = 20;
+        int districts = 18;
+        uint64_t seed = 1;
+    };
+
+    explicit NetworkGenerator(const Parameters& parameters);
+
+    /**
+     * @return An empty string if the parameters can be used, otherwise what is wrong with them
+     */
+    std::string validate() const;
+
+    /**
+     * Writes the stations and the segments of the network. The segments are all distinct, in either direction.
+     *
+     * Time complexity: O(S), S being the number of stations.
+     * @param stationsFile Path of the CSV file of the stations
+     * @param networkFile Path of the CSV file of the segments
+     * @return The number of segments written, -1 if a file could not be written
+     */
+    long write(const std::string& stationsFile, const std::string& networkFile) const;
+
+private:
+    /**
+     * @return A number in [0, n), every one being equally likely
+     */
+    static uint64_t uniform(std::mt19937_64& rng, uint64_t n);
+
+    /**
+     * @return A number in [0, 1)
+     */
+    static double uniformReal(std::mt19937_64& rng);
+
+    int capacity(std::mt19937_64& rng) const;
+
+    Parameters parameters;
+};
+
+#endif //PROJECT_NETWORKGENERATOR_H
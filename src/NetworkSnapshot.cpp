@@ -0,0 +1,247 @@
+#include "NetworkSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+    const char MAGIC[8] = {'T', 'R', 'A', 'I', 'N', 'N', 'E', 'T'};
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // every section starts at a multiple of 8 bytes so that its records can be read in place
+    uint64_t align(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    template<typename T>
+    void put(vector<char>& buffer, uint64_t at, const T* values, size_t count) {
+        if (count > 0) memcpy(buffer.data() + at, values, count * sizeof(T));
+    }
+}
+
+NetworkSnapshot::~NetworkSnapshot() {
+    close();
+}
+
+bool NetworkSnapshot::getFileStamp(const string &path, uint64_t &size, int64_t &time) {
+    struct stat info{};
+    if (stat(path.c_str(), &info) != 0) return false;
+    size = info.st_size;
+    time = info.st_mtime;
+    return true;
+}
+
+bool NetworkSnapshot::write(const string &path, const Graph &g, const vector<string> &sources) {
+    if (sources.size() > MAX_SOURCES) return false;
+    Header h{};
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.formatVersion = FORMAT_VERSION;
+    h.numSources = sources.size();
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (!getFileStamp(sources[i], h.sourceSize[i], h.sourceTime[i])) return false;
+    }
+
+    // intern every string, the first occurrence deciding its index
+    vector<string> strings;
+    unordered_map<string, uint32_t> ids;
+    auto intern = [&](const string& s) {
+        auto it = ids.emplace(s, strings.size());
+        if (it.second) strings.push_back(s);
+        return it.first->second;
+    };
+
+    vector<Vertex*> vertices = g.getVertexSet();
+    unordered_map<const Vertex*, uint32_t> index;
+    vector<StationRecord> stationRecords(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        index[vertices[i]] = i;
+        const Station& s = vertices[i]->getStation();
+        stationRecords[i] = {intern(s.getName()), intern(s.getDistrict()), intern(s.getMunicipality()),
+                             intern(s.getTownship()), intern(s.getLine())};
+    }
+
+    vector<uint32_t> arcStart(vertices.size() + 1, 0);
+    unordered_map<const Edge*, uint32_t> arcOf;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        arcStart[i + 1] = arcStart[i];
+        for (Edge* e : vertices[i]->getAdj()) {
+            arcOf[e] = arcStart[i + 1]++;
+        }
+    }
+    vector<ArcRecord> arcRecords(arcStart.back());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        for (Edge* e : vertices[i]->getAdj()) {
+            uint32_t reverse = e->getReverse() == nullptr ? NO_REVERSE : arcOf[e->getReverse()];
+            arcRecords[arcOf[e]] = {index[e->getDest()], e->getWeight(), intern(e->getService()), reverse};
+        }
+    }
+
+    vector<uint32_t> stringOffsets(strings.size() + 1, 0);
+    for (size_t i = 0; i < strings.size(); i++) {
+        stringOffsets[i + 1] = stringOffsets[i] + strings[i].size();
+    }
+
+    h.numStrings = strings.size();
+    h.numStations = stationRecords.size();
+    h.numArcs = arcRecords.size();
+    h.stringOffsetsAt = align(sizeof(Header));
+    h.stringDataAt = align(h.stringOffsetsAt + stringOffsets.size() * sizeof(uint32_t));
+    h.stringDataSize = stringOffsets.back();
+    h.stationsAt = align(h.stringDataAt + h.stringDataSize);
+    h.firstArcAt = align(h.stationsAt + stationRecords.size() * sizeof(StationRecord));
+    h.arcsAt = align(h.firstArcAt + arcStart.size() * sizeof(uint32_t));
+    h.fileSize = h.arcsAt + arcRecords.size() * sizeof(ArcRecord);
+
+    vector<char> buffer(h.fileSize, 0);
+    put(buffer, 0, &h, 1);
+    put(buffer, h.stringOffsetsAt, stringOffsets.data(), stringOffsets.size());
+    for (size_t i = 0; i < strings.size(); i++) {
+        put(buffer, h.stringDataAt + stringOffsets[i], strings[i].data(), strings[i].size());
+    }
+    put(buffer, h.stationsAt, stationRecords.data(), stationRecords.size());
+    put(buffer, h.firstArcAt, arcStart.data(), arcStart.size());
+    put(buffer, h.arcsAt, arcRecords.data(), arcRecords.size());
+
+    string temporary = path + ".tmp" + to_string(getpid());
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write(buffer.data(), buffer.size());
+        if (!out) {
+            out.close();
+            remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool NetworkSnapshot::open(const string &path, const vector<string> &sources) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    data = static_cast<const char*>(mapped);
+    size = info.st_size;
+    header = reinterpret_cast<const Header*>(data);
+    if (!validate(sources)) {
+        close();
+        return false;
+    }
+    stringOffsets = reinterpret_cast<const uint32_t*>(data + header->stringOffsetsAt);
+    stringData = data + header->stringDataAt;
+    stations = reinterpret_cast<const StationRecord*>(data + header->stationsAt);
+    firstArc = reinterpret_cast<const uint32_t*>(data + header->firstArcAt);
+    arcs = reinterpret_cast<const ArcRecord*>(data + header->arcsAt);
+    return true;
+}
+
+bool NetworkSnapshot::validate(const vector<string> &sources) const {
+    const Header& h = *header;
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.byteOrder != BYTE_ORDER_MARK) return false;
+    if (h.formatVersion != FORMAT_VERSION || h.fileSize != size) return false;
+
+    // a snapshot is only valid for the files it was written from, as they are now
+    if (h.numSources != sources.size()) return false;
+    for (size_t i = 0; i < sources.size(); i++) {
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        if (!getFileStamp(sources[i], sourceSize, sourceTime)) return false;
+        if (sourceSize != h.sourceSize[i] || sourceTime != h.sourceTime[i]) return false;
+    }
+
+    auto fits = [&](uint64_t at, uint64_t count, uint64_t recordSize) {
+        return at % 8 == 0 && at <= size && count <= (size - at) / recordSize;
+    };
+    if (!fits(h.stringOffsetsAt, h.numStrings + 1ULL, sizeof(uint32_t))) return false;
+    if (h.stringDataAt > size || h.stringDataSize > size - h.stringDataAt) return false;
+    if (!fits(h.stationsAt, h.numStations, sizeof(StationRecord))) return false;
+    if (!fits(h.firstArcAt, h.numStations + 1ULL, sizeof(uint32_t))) return false;
+    if (!fits(h.arcsAt, h.numArcs, sizeof(ArcRecord))) return false;
+
+    auto offsets = reinterpret_cast<const uint32_t*>(data + h.stringOffsetsAt);
+    if (offsets[0] != 0 || offsets[h.numStrings] != h.stringDataSize) return false;
+    for (uint32_t i = 0; i < h.numStrings; i++) {
+        if (offsets[i] > offsets[i + 1]) return false;
+    }
+    auto stationRecords = reinterpret_cast<const StationRecord*>(data + h.stationsAt);
+    for (uint32_t i = 0; i < h.numStations; i++) {
+        const StationRecord& s = stationRecords[i];
+        if (s.name >= h.numStrings || s.district >= h.numStrings || s.municipality >= h.numStrings ||
+            s.township >= h.numStrings || s.line >= h.numStrings) return false;
+    }
+    auto arcStart = reinterpret_cast<const uint32_t*>(data + h.firstArcAt);
+    if (arcStart[0] != 0 || arcStart[h.numStations] != h.numArcs) return false;
+    for (uint32_t i = 0; i < h.numStations; i++) {
+        if (arcStart[i] > arcStart[i + 1]) return false;
+    }
+    auto arcRecords = reinterpret_cast<const ArcRecord*>(data + h.arcsAt);
+    for (uint32_t i = 0; i < h.numStations; i++) {
+        for (uint32_t a = arcStart[i]; a < arcStart[i + 1]; a++) {
+            const ArcRecord& r = arcRecords[a];
+            if (r.target >= h.numStations || r.service >= h.numStrings) return false;
+            if (r.reverse == NO_REVERSE) continue;
+            // the reverse arc must go back from the destination to station i
+            if (r.reverse >= h.numArcs || arcRecords[r.reverse].reverse != a) return false;
+            if (arcRecords[r.reverse].target != i) return false;
+        }
+    }
+    return true;
+}
+
+void NetworkSnapshot::close() {
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    stringOffsets = nullptr;
+    stringData = nullptr;
+    stations = nullptr;
+    firstArc = nullptr;
+    arcs = nullptr;
+}
+
+uint32_t NetworkSnapshot::getNumStrings() const {
+    return header->numStrings;
+}
+
+string NetworkSnapshot::getString(uint32_t i) const {
+    return string(stringData + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]);
+}
+
+uint32_t NetworkSnapshot::getNumStations() const {
+    return header->numStations;
+}
+
+const NetworkSnapshot::StationRecord &NetworkSnapshot::getStation(uint32_t i) const {
+    return stations[i];
+}
+
+uint32_t NetworkSnapshot::getNumArcs() const {
+    return header->numArcs;
+}
+
+uint32_t NetworkSnapshot::getFirstArc(uint32_t i) const {
+    return firstArc[i];
+}
+
+const NetworkSnapshot::ArcRecord &NetworkSnapshot::getArc(uint32_t a) const {
+    return arcs[a];
+}
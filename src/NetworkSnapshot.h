@@ -0,0 +1,137 @@
+#ifndef PROJECT_NETWORKSNAPSHOT_H
+#define PROJECT_NETWORKSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../data_structures/Graph.h"
+
+/**
+ * Binary copy of a train network that can be used instead of the CSV files to start the program faster.
+ *
+ * The file is mapped into memory and read in place: every string is stored once in a string table and referred to
+ * by its index, the stations form a table of fixed size records and the segments are stored in compressed sparse
+ * row form, the arcs of every station being contiguous and in the order of its adjacency list. Numbers are stored
+ * in the byte order of the machine that wrote the file, so a snapshot written by a different architecture is
+ * rejected like any other invalid file.
+ * The size and modification time of the CSV files the network was loaded from are saved in the header, so that a
+ * snapshot is not used after those files change.
+ */
+class NetworkSnapshot {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint32_t NO_REVERSE = UINT32_MAX;
+    static const int MAX_SOURCES = 4;
+
+    /**
+     * A station, every field being the index of a string in the string table.
+     */
+    struct StationRecord {
+        uint32_t name;
+        uint32_t district;
+        uint32_t municipality;
+        uint32_t township;
+        uint32_t line;
+    };
+
+    /**
+     * An edge of the graph, stored in the arc range of its origin station.
+     */
+    struct ArcRecord {
+        uint32_t target;    // index of the destination station
+        int32_t capacity;
+        uint32_t service;   // index of a string
+        uint32_t reverse;   // index of the reverse arc, NO_REVERSE if the edge has none
+    };
+
+    NetworkSnapshot() = default;
+    ~NetworkSnapshot();
+    NetworkSnapshot(const NetworkSnapshot&) = delete;
+    NetworkSnapshot& operator=(const NetworkSnapshot&) = delete;
+
+    /**
+     * Writes a snapshot of a graph. The file is written next to its final path and then renamed, so a process
+     * starting at the same time never sees it half written.
+     * Time complexity: O(V + E).
+     * @param path Path of the snapshot
+     * @param g The graph, usually just loaded from the CSV files
+     * @param sources Paths of the files the graph was loaded from
+     * @return true if the snapshot was written
+     */
+    static bool write(const std::string& path, const Graph& g, const std::vector<std::string>& sources);
+
+    /**
+     * Maps a snapshot into memory and checks that it is complete, consistent and newer than its source files.
+     * Time complexity: O(V + E) integer checks, nothing is parsed or copied.
+     * @param path Path of the snapshot
+     * @param sources Paths of the files the snapshot must have been written from
+     * @return true if the snapshot can be used
+     */
+    bool open(const std::string& path, const std::vector<std::string>& sources);
+
+    /**
+     * Unmaps the snapshot, the records returned before can no longer be used.
+     */
+    void close();
+
+    uint32_t getNumStrings() const;
+    /**
+     * @param i Index of a string
+     * @return A copy of the string
+     */
+    std::string getString(uint32_t i) const;
+
+    uint32_t getNumStations() const;
+    const StationRecord& getStation(uint32_t i) const;
+
+    uint32_t getNumArcs() const;
+    /**
+     * @param i Index of a station
+     * @return The index of the first arc of station i, the arcs of i ending where the ones of i + 1 begin
+     */
+    uint32_t getFirstArc(uint32_t i) const;
+    const ArcRecord& getArc(uint32_t a) const;
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t byteOrder;
+        uint32_t formatVersion;
+        uint32_t numSources;
+        uint32_t numStrings;
+        uint32_t numStations;
+        uint32_t numArcs;
+        uint64_t sourceSize[MAX_SOURCES];
+        int64_t sourceTime[MAX_SOURCES];
+        uint64_t stringOffsetsAt;   // numStrings + 1 uint32_t, string i is [offsets[i], offsets[i+1]) of the data
+        uint64_t stringDataAt;
+        uint64_t stringDataSize;
+        uint64_t stationsAt;        // numStations StationRecord
+        uint64_t firstArcAt;        // numStations + 1 uint32_t
+        uint64_t arcsAt;            // numArcs ArcRecord
+        uint64_t fileSize;
+    };
+
+    /**
+     * Gets the size and modification time of a file.
+     * @return false if the file does not exist
+     */
+    static bool getFileStamp(const std::string& path, uint64_t& size, int64_t& time);
+
+    /**
+     * Checks every index stored in the mapped file.
+     * @return true if the file can be read safely
+     */
+    bool validate(const std::vector<std::string>& sources) const;
+
+    const char* data = nullptr;
+    size_t size = 0;
+    const Header* header = nullptr;
+    const uint32_t* stringOffsets = nullptr;
+    const char* stringData = nullptr;
+    const StationRecord* stations = nullptr;
+    const uint32_t* firstArc = nullptr;
+    const ArcRecord* arcs = nullptr;
+};
+
+#endif //PROJECT_NETWORKSNAPSHOT_H
@@ -0,0 +1,144 @@
+#include "QueryServer.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+    /**
+     * Sends the whole buffer, unless the client closed the connection.
+     * @return true if everything was sent
+     */
+    bool sendAll(int fd, const string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+}
+
+QueryServer::QueryServer(TrainManager& manager) : manager(manager) {
+    manager.prepareQueries();
+}
+
+QueryServer::~QueryServer() {
+    if (listener != -1) close(listener);
+    if (!socketPath.empty()) unlink(socketPath.c_str());
+}
+
+bool QueryServer::listen(const string& address) {
+    bool tcp = !address.empty() && address.find_first_not_of("0123456789") == string::npos;
+    if (tcp) {
+        unsigned long port = stoul(address);
+        if (port == 0 || port > 65535) {
+            cerr << "Invalid port " << address << "!\n";
+            return false;
+        }
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == -1) {
+            cerr << "Could not create the socket: " << strerror(errno) << "\n";
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, (sockaddr*) &addr, sizeof(addr)) == -1) {
+            cerr << "Could not listen on port " << address << ": " << strerror(errno) << "\n";
+            return false;
+        }
+    }
+    else {
+        sockaddr_un addr{};
+        if (address.empty() || address.size() >= sizeof(addr.sun_path)) {
+            cerr << "Invalid socket path " << address << "!\n";
+            return false;
+        }
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener == -1) {
+            cerr << "Could not create the socket: " << strerror(errno) << "\n";
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, address.c_str(), address.size() + 1);
+        unlink(address.c_str());
+        if (bind(listener, (sockaddr*) &addr, sizeof(addr)) == -1) {
+            cerr << "Could not listen on " << address << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        socketPath = address;
+    }
+    if (::listen(listener, SOMAXCONN) == -1) {
+        cerr << "Could not listen on " << address << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+void QueryServer::run() {
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // out of file descriptors or threads, wait for a client to leave
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+                continue;
+            }
+            cerr << "Could not accept a client: " << strerror(errno) << "\n";
+            return;
+        }
+        thread(&QueryServer::serve, this, fd).detach();
+    }
+}
+
+void QueryServer::serve(int fd) {
+    WorkspacePool::Lease ws = workspaces.acquire();
+    string pending, answers;
+    bool skipping = false;  // inside a line longer than MAX_LINE
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pending.append(buffer, n);
+
+        // answer every complete line received, and send the answers together
+        size_t start = 0, end;
+        while ((end = pending.find('\n', start)) != string::npos) {
+            string line = pending.substr(start, end - start);
+            start = end + 1;
+            if (skipping) {
+                skipping = false;
+                continue;
+            }
+            if (!TrainManager::isQuery(line)) continue;
+            ostringstream result;
+            string error = manager.answerQuery(TrainManager::splitQuery(line), *ws, result);
+            if (error.empty()) answers += "ok" + result.str() + "\n";
+            else answers += "error\t" + error + "\n";
+        }
+        pending.erase(0, start);
+        if (pending.size() > MAX_LINE) {
+            if (!skipping) answers += "error\tline too long\n";
+            skipping = true;
+            pending.clear();
+        }
+        if (!answers.empty() && !sendAll(fd, answers)) break;
+        answers.clear();
+    }
+    close(fd);
+}
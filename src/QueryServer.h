@@ -0,0 +1,62 @@
+#ifndef PROJECT_QUERYSERVER_H
+#define PROJECT_QUERYSERVER_H
+
+#include <string>
+#include "TrainManager.h"
+#include "../data_structures/WorkspacePool.h"
+
+/**
+ * Answers the queries of local clients over a Unix domain socket or a TCP port of localhost, so that the network is
+ * loaded once for any number of queries.
+ *
+ * The protocol is the one of TrainManager::runBatch, one line per query and one line per answer: a client sends
+ * lines of fields separated by tabs and gets back, for each one and in order, "ok" followed by the fields of the
+ * result or "error" followed by the reason, separated by tabs. Every client is served by its own thread with a
+ * FlowWorkspace of its own, taken from a pool when it connects and given back when it leaves, so the flows between
+ * two stations asked by different clients are computed at the same time without allocating a workspace for every
+ * connection.
+ */
+class QueryServer {
+public:
+    /**
+     * @param manager Answers the queries, it must outlive the server and its network must not be modified while it
+     * is serving
+     */
+    explicit QueryServer(TrainManager& manager);
+    ~QueryServer();
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * Starts listening for clients. An address made only of digits is a TCP port, bound to 127.0.0.1 so that only
+     * local clients can connect, anything else is the path of a Unix domain socket, which replaces any file at that
+     * path.
+     * @param address The port or the path
+     * @return true if successful, false if the socket could not be created, in which case the reason is written to
+     * cerr
+     */
+    bool listen(const std::string& address);
+
+    /**
+     * Accepts clients forever, starting a thread for each one.
+     * @return Only if accepting a client fails for a reason other than an interruption
+     */
+    void run();
+
+private:
+    /**
+     * Answers the lines sent by a client until it closes the connection. Lines longer than MAX_LINE are answered
+     * with an error and skipped.
+     * @param fd Socket of the client, closed on return
+     */
+    void serve(int fd);
+
+    static const size_t MAX_LINE = 1 << 16;
+
+    TrainManager& manager;
+    int listener = -1;
+    std::string socketPath;     // removed when the server is destroyed, empty for TCP
+    WorkspacePool workspaces;
+};
+
+#endif //PROJECT_QUERYSERVER_H
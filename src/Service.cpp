@@ -0,0 +1,40 @@
+#include "Service.h"
+#include <vector>
+#include "../data_structures/StringPool.h"
+using namespace std;
+
+namespace {
+    struct ServiceTable {
+        StringPool names;
+        vector<int> costs;
+
+        ServiceTable() {
+            names.intern("STANDARD");
+            costs.push_back(Service::STANDARD_COST);
+        }
+
+        unsigned int add(string_view name) {
+            unsigned int id = names.intern(name);
+            if (id == costs.size()) costs.push_back(Service::DEFAULT_COST);
+            return id;
+        }
+    };
+
+    ServiceTable& table() {
+        static ServiceTable services;
+        return services;
+    }
+}
+
+Service::Service() : id(STANDARD) {}
+
+Service::Service(string_view name) : id(table().add(name)) {}
+
+unsigned int Service::getId() const {return id;}
+const string& Service::getName() const {return table().names.get(id);}
+int Service::getCost() const {return table().costs[id];}
+bool Service::operator==(const Service &a) const {return a.id == id;}
+
+int Service::getCost(unsigned int id) {return table().costs[id];}
+void Service::setCost(string_view name, int cost) {table().costs[table().add(name)] = cost;}
+unsigned int Service::getNumServices() {return table().names.size();}
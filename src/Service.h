@@ -0,0 +1,77 @@
+#ifndef PROJECT_SERVICE_H
+#define PROJECT_SERVICE_H
+#include <string>
+#include <string_view>
+
+/**
+ * Class of service of a segment of the train network, such as STANDARD or ALFA PENDULAR.
+ *
+ * Services are identified by dense integers given in order of first use, STANDARD always being 0, so segments
+ * can be filtered and priced with integer operations. Every service has a cost per train, kept in a table shared
+ * by the whole program, that can be configured when the network is loaded. Services not configured cost
+ * DEFAULT_COST.
+ */
+class Service {
+public:
+    static constexpr unsigned int STANDARD = 0;
+    static constexpr int STANDARD_COST = 2;
+    static constexpr int DEFAULT_COST = 4;
+
+    /**
+     * Constructs the STANDARD service.
+     * This method has a time complexity of O(1).
+     */
+    Service();
+    /**
+     * Constructs the service with the given name, adding it to the table of services if it is new.
+     * This method has a time complexity of O(n) on average, where n is the length of the name.
+     * @param name The name of the service.
+     */
+    explicit Service(std::string_view name);
+
+    /**
+     * This method has a time complexity of O(1).
+     * @return The identifier of the service.
+     */
+    unsigned int getId() const;
+    /**
+     * This method has a time complexity of O(1).
+     * @return The name of the service.
+     */
+    const std::string& getName() const;
+    /**
+     * This method has a time complexity of O(1).
+     * @return The cost of a train using a segment of this service, per unit of capacity.
+     */
+    int getCost() const;
+    /**
+     * @param a The Service object to compare with.
+     * @return true if both are the same service.
+     */
+    bool operator==(const Service& a) const;
+
+    /**
+     * This method has a time complexity of O(1).
+     * @param id The identifier of a service.
+     * @return The cost of that service.
+     */
+    static int getCost(unsigned int id);
+    /**
+     * Changes the cost of a service, adding it to the table if it is new. Copies of the network that were already
+     * built (like CSRGraph) keep the costs they were built with.
+     * This method has a time complexity of O(n) on average, where n is the length of the name.
+     * @param name The name of the service.
+     * @param cost The new cost.
+     */
+    static void setCost(std::string_view name, int cost);
+    /**
+     * @return The number of services, every identifier being smaller than it.
+     */
+    static unsigned int getNumServices();
+
+private:
+    unsigned int id;
+};
+
+
+#endif //PROJECT_SERVICE_H
@@ -5,29 +5,65 @@
 #include "Station.h"
 using namespace std;
 
+namespace {
+    // one pool per kind of attribute, so that the identifiers of each kind are dense
+    StringPool& names() {
+        static StringPool pool;
+        return pool;
+    }
+    StringPool& districts() {
+        static StringPool pool;
+        return pool;
+    }
+    StringPool& municipalities() {
+        static StringPool pool;
+        return pool;
+    }
+    StringPool& townships() {
+        static StringPool pool;
+        return pool;
+    }
+    StringPool& lines() {
+        static StringPool pool;
+        return pool;
+    }
+}
+
 Station::Station(const string& name, const string& district,const string& municipality,
                  const string& township, const string& line)
-                 :name(name),district(district),municipality(municipality),township(township),line(line)
+                 :name(names().intern(name)),district(districts().intern(district)),
+                 municipality(municipalities().intern(municipality)),township(townships().intern(township)),
+                 line(lines().intern(line))
                  {}
 
-Station::Station() = default;
+Station::Station() : Station("","","","","") {}
 
-string Station::getName() const {return name;}
-string Station::getDistrict() const {return district;}
-string Station::getMunicipality() const {return municipality;}
-string Station::getTownship() const {return township;}
-string Station::getLine() const {return line;}
+const string& Station::getName() const {return names().get(name);}
+const string& Station::getDistrict() const {return districts().get(district);}
+const string& Station::getMunicipality() const {return municipalities().get(municipality);}
+const string& Station::getTownship() const {return townships().get(township);}
+const string& Station::getLine() const {return lines().get(line);}
 
-void Station::setName(const string &name) {this->name = name;}
-void Station::setDistrict(const string &district) {this->district = district;}
-void Station::setMunicipality(const string &municipality) {this->municipality = municipality;}
-void Station::setTownship(const string &township) {this->township = township;}
-void Station::setLine(const string &line) {this->line = line;}
+unsigned int Station::getNameId() const {return name;}
+unsigned int Station::getDistrictId() const {return district;}
+unsigned int Station::getMunicipalityId() const {return municipality;}
+unsigned int Station::getTownshipId() const {return township;}
+unsigned int Station::getLineId() const {return line;}
 
-bool Station::operator==(Station &a) const {
-    return a.getName() == name && a.getDistrict() == district &&
-    a.getLine() == line && a.getMunicipality() == municipality &&
-    a.getTownship() == township;
-}
+const StringPool& Station::getNamePool() {return names();}
+const StringPool& Station::getDistrictPool() {return districts();}
+const StringPool& Station::getMunicipalityPool() {return municipalities();}
+const StringPool& Station::getTownshipPool() {return townships();}
+const StringPool& Station::getLinePool() {return lines();}
 
+void Station::setName(const string &name) {this->name = names().intern(name);}
+void Station::setDistrict(const string &district) {this->district = districts().intern(district);}
+void Station::setMunicipality(const string &municipality) {this->municipality = municipalities().intern(municipality);}
+void Station::setTownship(const string &township) {this->township = townships().intern(township);}
+void Station::setLine(const string &line) {this->line = lines().intern(line);}
 
+bool Station::operator==(const Station &a) const {
+    return a.name == name && a.district == district &&
+    a.line == line && a.municipality == municipality &&
+    a.township == township;
+}
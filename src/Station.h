@@ -5,20 +5,21 @@
 #ifndef PROJECT_STATION_H
 #define PROJECT_STATION_H
 #include <string>
-
+#include "../data_structures/StringPool.h"
 
 
 class Station {
 public:
     /**
-     * Constructs a new Station object with default values.
+     * Constructs a new Station object with default values, every field being empty.
      * This method has a time complexity of O(1).
      */
     Station();
     /**
      * This constructor initializes a new Station object with the given attributes such as name, district,
-     * municipality, township, and line.
-     * This method has a time complexity of O(1).
+     * municipality, township, and line. Each attribute is interned in the pool of its kind, the station only keeps
+     * their identifiers.
+     * This method has a time complexity of O(n) on average, where n is the length of the attributes.
      * @param name The name of the station.
      * @param district The district the station is located in.
      * @param municipality The municipality the station is located in.
@@ -32,31 +33,84 @@ public:
      * This method has a time complexity of O(1).
      * @return The name of the Station object.
      */
-    std::string getName() const;
+    const std::string& getName() const;
     /**
      * Gets the district of the station.
      * This method has a time complexity of O(1).
      * @return The district of the Station object.
      */
-    std::string getDistrict() const;
+    const std::string& getDistrict() const;
     /**
      * Gets the municipality of the station.
      * This method has a time complexity of O(1).
      * @return The municipality of the Station object.
      */
-    std::string getMunicipality() const;
+    const std::string& getMunicipality() const;
     /**
      * Gets the township of the station.
      * This method has a time complexity of O(1).
      * @return The township of the Station object.
      */
-    std::string getTownship() const;
+    const std::string& getTownship() const;
     /**
      * Gets the line of the station.
      * This method has a time complexity of O(1).
      * @return The line of the Station object.
      */
-    std::string getLine() const;
+    const std::string& getLine() const;
+
+    /**
+     * Gets the identifier of the name of the station. Stations with the same name share it, so it identifies the
+     * name and not the station. Identifiers are dense integers given in order of first use.
+     * This method has a time complexity of O(1).
+     * @return The identifier of the name in getNamePool().
+     */
+    unsigned int getNameId() const;
+    /**
+     * Gets the identifier of the district of the station.
+     * This method has a time complexity of O(1).
+     * @return The identifier of the district in getDistrictPool().
+     */
+    unsigned int getDistrictId() const;
+    /**
+     * Gets the identifier of the municipality of the station.
+     * This method has a time complexity of O(1).
+     * @return The identifier of the municipality in getMunicipalityPool().
+     */
+    unsigned int getMunicipalityId() const;
+    /**
+     * Gets the identifier of the township of the station.
+     * This method has a time complexity of O(1).
+     * @return The identifier of the township in getTownshipPool().
+     */
+    unsigned int getTownshipId() const;
+    /**
+     * Gets the identifier of the line of the station, equal for all the stations of the same line.
+     * This method has a time complexity of O(1).
+     * @return The identifier of the line in getLinePool().
+     */
+    unsigned int getLineId() const;
+
+    /**
+     * @return The names of every station created so far.
+     */
+    static const StringPool& getNamePool();
+    /**
+     * @return The districts of every station created so far.
+     */
+    static const StringPool& getDistrictPool();
+    /**
+     * @return The municipalities of every station created so far.
+     */
+    static const StringPool& getMunicipalityPool();
+    /**
+     * @return The townships of every station created so far.
+     */
+    static const StringPool& getTownshipPool();
+    /**
+     * @return The lines of every station created so far.
+     */
+    static const StringPool& getLinePool();
 
     /**
      * Sets the name of the station.
@@ -91,18 +145,19 @@ public:
     /**
      * Check whether this Station is equal to another Station.
      * The comparison is made based on the equality of the name, district, municipality,
-     * township, and line of the two Station objects.
+     * township, and line of the two Station objects, comparing their identifiers.
+     * This method has a time complexity of O(1).
      * @param a The Station object to compare with.
      * @return true if the two Station objects are equal, false otherwise.
      */
-    bool operator ==(Station& a) const;
+    bool operator ==(const Station& a) const;
 
 private:
-    std::string name;
-    std::string district;
-    std::string municipality;
-    std::string township;
-    std::string line;
+    unsigned int name;
+    unsigned int district;
+    unsigned int municipality;
+    unsigned int township;
+    unsigned int line;
 
 };
 
@@ -7,85 +7,170 @@
 #include <sstream>
 #include <iostream>
 #include <climits>
+#include <chrono>
+#include <iomanip>
+#include <charconv>
+#include <string_view>
 #include "Network.h"
+#include "NetworkSnapshot.h"
+#include "CsvReader.h"
+#include "../data_structures/Instrumentation.h"
 using namespace std;
 
-TrainManager::TrainManager() {
+namespace {
+    const string STATIONS_FILE = "../resources/stations2.csv";
+    const string NETWORK_FILE = "../resources/network2.csv";
+    const string SNAPSHOT_FILE = "../resources/network2.snapshot";
+    const string SERVICES_FILE = "../resources/services.csv";
+
+    /**
+     * @return true if the field is a positive number, which is stored in k
+     */
+    bool parseCount(const string& field, int& k) {
+        auto res = from_chars(field.data(), field.data() + field.size(), k);
+        return res.ec == errc() && res.ptr == field.data() + field.size() && k > 0;
+    }
+}
+
+TrainManager::TrainManager() : stationsFile(STATIONS_FILE), networkFile(NETWORK_FILE) {
+    LoadServices();
+    if (LoadSnapshot(SNAPSHOT_FILE)) return;
     LoadStations();
     LoadNetworks();
+    NetworkSnapshot::write(SNAPSHOT_FILE, trainNetwork, {stationsFile, networkFile});
 }
 
-void TrainManager::LoadStations() {
-    string name, district, municipality, township, line , s;
-    ifstream in; in.open("../resources/stations2.csv");
-    if(!in) cerr << "Could not open the file!" << endl;
-    getline(in,s);
-    while(getline(in,s)) {
-        istringstream iss(s);
-
-        getline(iss, name, ',');
-        getline(iss, district, ',');
-        getline(iss, municipality, ',');
-
-        if (iss.peek() == '"') {
-            getline(iss, township, '"');
-            getline(iss, township, '"');
-        } else {
-            getline(iss, township, ',');
+TrainManager::TrainManager(string stationsFile, string networkFile) :
+        stationsFile(std::move(stationsFile)), networkFile(std::move(networkFile)) {
+    LoadServices();
+}
+
+bool TrainManager::LoadSnapshot(const string& path) {
+    TIME_PHASE(LOAD_SNAPSHOT);
+    NetworkSnapshot snapshot;
+    if (!snapshot.open(path, {stationsFile, networkFile})) return false;
+
+    vector<string> strings(snapshot.getNumStrings());
+    for (uint32_t i = 0; i < strings.size(); i++) {
+        strings[i] = snapshot.getString(i);
+    }
+    vector<Vertex*> vertices(snapshot.getNumStations());
+    for (uint32_t i = 0; i < vertices.size(); i++) {
+        const NetworkSnapshot::StationRecord& r = snapshot.getStation(i);
+        Station a = Station(strings[r.name],strings[r.district],strings[r.municipality],strings[r.township],
+                            strings[r.line]);
+        stations.emplace(strings[r.name],a);
+        vertices[i] = trainNetwork.appendVertex(a);
+    }
+    // the edges are added in the order of the adjacency lists, then paired with their reverse
+    vector<Edge*> edges(snapshot.getNumArcs());
+    for (uint32_t i = 0; i < vertices.size(); i++) {
+        for (uint32_t a = snapshot.getFirstArc(i); a < snapshot.getFirstArc(i + 1); a++) {
+            const NetworkSnapshot::ArcRecord& r = snapshot.getArc(a);
+            edges[a] = trainNetwork.appendEdge(vertices[i],vertices[r.target],r.capacity,strings[r.service]);
         }
-        getline(iss, line, ',');
-        getline(iss, line, '\n');
+    }
+    for (uint32_t a = 0; a < edges.size(); a++) {
+        uint32_t reverse = snapshot.getArc(a).reverse;
+        if (reverse != NetworkSnapshot::NO_REVERSE && a < reverse) trainNetwork.pairEdges(edges[a],edges[reverse]);
+    }
+    return true;
+}
+
+void TrainManager::LoadServices() {
+    CsvReader csv;
+    if (!csv.open(SERVICES_FILE)) return;
+    vector<string_view> fields;
+    csv.readRecord(fields);
+    while (csv.readRecord(fields)) {
+        if (fields.size() < 2) continue;
+        int cost;
+        string_view value = fields[1];
+        if (from_chars(value.data(), value.data() + value.size(), cost).ec != errc() || cost < 0) continue;
+        Service::setCost(fields[0], cost);
+    }
+}
+
+void TrainManager::LoadStations() {
+    TIME_PHASE(LOAD_STATIONS);
+    // the fields are views of the file, only copied once a station is known to be new
+    string name, district, municipality, township, line;
+    CsvReader csv;
+    if(!csv.open(stationsFile)) cerr << "Could not open the file!" << endl;
+    vector<string_view> fields;
+    csv.readRecord(fields);
+    long rows = 0;
+    while(csv.readRecord(fields)) {
+        rows++;
+        if (fields.size() < 5) continue;
+        name.assign(fields[0]);
+        if (stations.find(name) != stations.end()) continue;
+        district.assign(fields[1]);
+        municipality.assign(fields[2]);
+        township.assign(fields[3]);
+        line.assign(fields[4]);
 
         Station a = Station(name,district,municipality,township,line);
-        auto it = stations.find(name);
-        if(it==stations.end()){
-            stations.emplace(name,a);
-            trainNetwork.addVertex(a);
-        }
+        stations.emplace(name,a);
+        trainNetwork.addVertex(a);
     }
+    COUNT_EVENTS(STATION_ROWS, rows);
 }
 
 void TrainManager::LoadNetworks() {
+    TIME_PHASE(LOAD_NETWORKS);
     int cap;
-    string sA, sB, serv, line;
-    double w = 0;
-    ifstream in; in.open("../resources/network2.csv");
-    if(!in) cerr << "Could not open the file! " << endl;
-    getline(in, line);
-    while(getline(in,line)) {
-        istringstream iss(line);
-        getline(iss, sA, ','); getline(iss, sB, ',');
-        iss >> cap; iss.ignore(1); getline(iss, serv, ',');
-        Network a = Network(sA,sB,cap,serv);
-        auto it = networks.find(a);
-        if(it==networks.end()) {
-            networks.emplace(a,w);
-            auto it2 = stations.find(sA);
-            auto it3 = stations.find(sB);
-            trainNetwork.addBidirectionalEdge(it2->second,it3->second,cap , serv);
-        }
+    string sA, sB, serv;
+    CsvReader csv;
+    if(!csv.open(networkFile)) cerr << "Could not open the file! " << endl;
+    vector<string_view> fields;
+    csv.readRecord(fields);
+    long rows = 0;
+    while(csv.readRecord(fields)) {
+        rows++;
+        if (fields.size() < 4) continue;
+        string_view capacity = fields[2];
+        if (from_chars(capacity.data(), capacity.data() + capacity.size(), cap).ec != errc()) continue;
+        sA.assign(fields[0]); sB.assign(fields[1]); serv.assign(fields[3]);
+        auto it2 = stations.find(sA);
+        auto it3 = stations.find(sB);
+        if (it2 == stations.end() || it3 == stations.end()) continue;
+        // repeated segments, in either direction, are rejected by the segment index of the graph
+        trainNetwork.addBidirectionalEdge(it2->second,it3->second,cap , serv);
     }
+    COUNT_EVENTS(NETWORK_ROWS, rows);
 }
 
 void TrainManager::stations_most_amount_trains() {
     unsigned long max = 0;
     vector<pair<Vertex*,Vertex*>>& res = pairsOfStationsWithBiggestMaxFlow;
+    discardOutdatedReports();
+    CSRGraph& network = getFlowNetwork();
     if (!res.empty()){
-        max = trainNetwork.edmondsKarp(res[0].first,res[0].second);
+        max = getPairFlows().get(network.indexOf(res[0].first),network.indexOf(res[0].second));
     }
     else{
         cout << "Calculating...\n";
-        for (int i = 0 ; i < trainNetwork.getNumVertex();i++){
-            for (int j = i+1 ; j < trainNetwork.getNumVertex();j++){
-                unsigned long temp = trainNetwork.edmondsKarp(trainNetwork.getVertexSet()[i],trainNetwork.getVertexSet()[j]);
-                if (temp > max){
-                    res.clear();
-                    max = temp;
-                    res.emplace_back(trainNetwork.getVertexSet()[i],trainNetwork.getVertexSet()[j]);
-                }
-                else if (temp == max){
-                    res.emplace_back(trainNetwork.getVertexSet()[i],trainNetwork.getVertexSet()[j]);
-                }
+        // every block keeps its own best pairs, merged in order so the result does not depend on the threads
+        int blocks = getNumPairBlocks();
+        vector<unsigned long> blockMax(blocks, 0);
+        vector<vector<pair<int,int>>> blockPairs(blocks);
+        visitPairFlows(blocks, [&](int b, int i, int j, unsigned long temp){
+            if (temp > blockMax[b]){
+                blockPairs[b].clear();
+                blockMax[b] = temp;
+            }
+            if (temp == blockMax[b]){
+                blockPairs[b].emplace_back(i,j);
+            }
+        });
+        for (int b = 0; b < blocks; b++){
+            max = std::max(max, blockMax[b]);
+        }
+        for (int b = 0; b < blocks; b++){
+            if (blockMax[b] != max) continue;
+            for (auto& p : blockPairs[b]){
+                res.emplace_back(network.getVertex(p.first),network.getVertex(p.second));
             }
         }
     }
@@ -106,22 +191,9 @@ void TrainManager::top_municipalities() {
     cout << "How many municipalities you want?";
     int k;
     cin >> k;
-    if (top_mun.empty()){
-        cout << "Calculating...\n";
-        for (int i = 0; i < trainNetwork.getNumVertex(); i++) {
-            auto it = top_mun.find(trainNetwork.getVertexSet()[i]->getStation().getMunicipality());
-            if (it != top_mun.end()) top_mun.emplace(trainNetwork.getVertexSet()[i]->getStation().getMunicipality(), 0);
-        }
-        for (int i = 0; i < trainNetwork.getNumVertex(); i++) {
-            for (int j = i+1; j < trainNetwork.getNumVertex(); j++) {
-                unsigned long temp = trainNetwork.edmondsKarp(trainNetwork.getVertexSet()[i],trainNetwork.getVertexSet()[j]);
-                top_mun[trainNetwork.getVertexSet()[i]->getStation().getMunicipality()] += temp;
-                top_mun[trainNetwork.getVertexSet()[j]->getStation().getMunicipality()] += temp;
-            }
-        }
-    }
-    vector<pair<string,unsigned long>> v(top_mun.begin(),top_mun.end());
-    sort(v.begin(), v.end(), value_comparator<string,unsigned long>());
+    discardOutdatedReports();
+    if (top_mun.empty()) cout << "Calculating...\n";
+    vector<pair<string,unsigned long>> v = rankGroups(top_mun,&Station::getMunicipalityId,Station::getMunicipalityPool());
     cout<<"The top-" << k << " municipalities are: \n";
     int i = 0;
     while(i<k && i < v.size()) {
@@ -134,22 +206,9 @@ void TrainManager::top_districts() {
     cout << "How many districts you want?";
     int k;
     cin >> k;
-    if (top_dis.empty()){
-        cout << "Calculating...\n";
-        for (int i = 0; i < trainNetwork.getNumVertex(); i++) {
-            auto it = top_dis.find(trainNetwork.getVertexSet()[i]->getStation().getDistrict());
-            if (it != top_dis.end()) top_dis.emplace(trainNetwork.getVertexSet()[i]->getStation().getDistrict(), 0);
-        }
-        for (int i = 0; i < trainNetwork.getNumVertex(); i++) {
-            for (int j = i+1; j < trainNetwork.getNumVertex(); j++) {
-                unsigned long temp = trainNetwork.edmondsKarp(trainNetwork.getVertexSet()[i],trainNetwork.getVertexSet()[j]);
-                top_dis[trainNetwork.getVertexSet()[i]->getStation().getDistrict()] += temp;
-                top_dis[trainNetwork.getVertexSet()[j]->getStation().getDistrict()] += temp;
-            }
-        }
-    }
-    vector<pair<string,unsigned long>> v(top_dis.begin(),top_dis.end());
-    sort(v.begin(), v.end(), value_comparator<string,unsigned long>());
+    discardOutdatedReports();
+    if (top_dis.empty()) cout << "Calculating...\n";
+    vector<pair<string,unsigned long>> v = rankGroups(top_dis,&Station::getDistrictId,Station::getDistrictPool());
     cout<<"The top " << k << " districts are: \n";
     int i = 0;
     while(i < k && i < v.size()) {
@@ -158,6 +217,18 @@ void TrainManager::top_districts() {
     }
 }
 
+vector<pair<string,unsigned long>> TrainManager::rankGroups(map<string, unsigned long>& totals,
+                                                           unsigned int (Station::*group)() const,
+                                                           const StringPool& names) {
+    discardOutdatedReports();
+    if (totals.empty()){
+        sumPairFlows(totals,group,names);
+    }
+    vector<pair<string,unsigned long>> v(totals.begin(),totals.end());
+    sort(v.begin(), v.end(), value_comparator<string,unsigned long>());
+    return v;
+}
+
 void TrainManager::maxFlowOfTrains() {
     auto stations_input = getStationsFromUser();
     Vertex* s = stations_input.first;
@@ -166,7 +237,8 @@ void TrainManager::maxFlowOfTrains() {
         cout << "Invalid station!\n";
         return;
     }
-    unsigned int max_flow = trainNetwork.edmondsKarp(s,t);
+    CSRGraph& network = getFlowNetwork();
+    unsigned long max_flow = network.maxFlow(workspace,network.indexOf(s),network.indexOf(t),engine);
     cout.clear();
     cout << endl;
     cout << "The maximum number of trains which can travel between station "
@@ -211,12 +283,15 @@ void TrainManager::calculateMaxFlowWithMinimumCost() {
         return;
     }
 
-    unsigned long res = trainNetwork.maxFlowAfterPrim(s,t);
-    cout << "The maximum amount of trains which can go from station " << s->getStation().getName() << " and " << t->getStation().getName() << " is "<<res <<".\n";
+    CSRGraph& network = getFlowNetwork();
+    FlowWithCost res = network.minCostMaxFlow(workspace,network.indexOf(s),network.indexOf(t));
+    cout << "The maximum amount of trains which can go from station " << s->getStation().getName() << " and " << t->getStation().getName() << " is "<<res.flow <<", with a minimum cost of "<<res.cost<<".\n";
 }
 
 void TrainManager::useSubGraph() {
     vector<Edge> deletedEdges;
+    // the failure analysis runs on the network as it was before any segment was deleted
+    const CSRGraph network = getFlowNetwork();
 
     while (true){
         cout << "==============================================================\n"
@@ -262,43 +337,30 @@ void TrainManager::useSubGraph() {
                 continue;
             }
 
+            // every deleted segment alone, and all of them together when there are several
+            vector<FailureScenarioEngine::Scenario> scenarios;
             for (Edge& e : deletedEdges){
-                Station s1 = e.getOrig()->getStation();
-                Station s2 = e.getDest()->getStation();
-                trainNetwork.addBidirectionalEdge(s1,s2,e.getWeight(),e.getService());
+                scenarios.push_back({{network.indexOf(e.getOrig()),network.indexOf(e.getDest())}});
             }
-            vector<Vertex*> tempVerteces;
-            for (Edge& e : deletedEdges){
-                tempVerteces.clear();
-                for (Vertex* v : trainNetwork.getVertexSet()){
-                    if (v->getStation().getLine() == e.getOrig()->getStation().getLine()){
-                        auto p = getMaxFlowToSingleStation(v);
-                        v->setIndegree(p);
-                    }
+            if (scenarios.size() > 1){
+                FailureScenarioEngine::Scenario all;
+                for (auto& scenario : scenarios) all.push_back(scenario[0]);
+                scenarios.push_back(all);
+            }
+            auto impacts = FailureScenarioEngine(network,driver).evaluate(scenarios);
+            for (size_t i = 0; i < impacts.size(); i++){
+                if (i < deletedEdges.size()){
+                    Edge& e = deletedEdges[i];
+                    cout << "The stations that were most affected from removing segment between stations "<< e.getOrig()->getStation().getName() << " and " << e.getDest()->getStation().getName() << " are:\n";
                 }
-                auto temp = trainNetwork.removeBidirectionalEdge(e.getOrig(),e.getDest());
-                for (Vertex* v : trainNetwork.getVertexSet()){
-                    if (v->getStation().getLine() == e.getOrig()->getStation().getLine()){
-                        auto p = getMaxFlowToSingleStation(v);
-                        int tempDiff  = p-v->getIndegree();
-                        if (tempDiff < 0 ) tempDiff *= -1;
-                        v->setIndegree(tempDiff);
-                        if (v->getIndegree() != 0) tempVerteces.push_back(v);
-                    }
+                else {
+                    cout << "The stations that were most affected from removing all the deleted segments together are:\n";
                 }
-                Station s1 = e.getOrig()->getStation();
-                Station s2 = e.getDest()->getStation();
-                trainNetwork.addBidirectionalEdge(s1,s2,e.getWeight(),e.getService());
-                sort(tempVerteces.begin(),tempVerteces.end(),[](Vertex* a , Vertex* b){ return a->getIndegree()>b->getIndegree();});
-                cout << "The stations that were most affected from removing segment between stations "<< e.getOrig()->getStation().getName() << " and " << e.getDest()->getStation().getName() << " are:\n";
-                for (int i = 0 ; (i < k) && (i <tempVerteces.size());i++){
-                   cout << "- " << tempVerteces[i]->getStation().getName() << "\n";
+                for (size_t j = 0 ; (j < (size_t) k) && (j < impacts[i].size());j++){
+                   cout << "- " << network.getVertex(impacts[i][j].station)->getStation().getName() << "\n";
                 }
                 cout << "\n";
             }
-            for (Edge& e : deletedEdges){
-                trainNetwork.removeBidirectionalEdge(e.getOrig(),e.getDest());
-            }
         }
         else if (choice == "4"){
             for (Edge& e : deletedEdges){
@@ -314,6 +376,174 @@ void TrainManager::useSubGraph() {
     }
 }
 
+int TrainManager::runBatch(istream& in, ostream& out) {
+    auto start = chrono::steady_clock::now();
+    Instrumentation::Totals before = Instrumentation::snapshot();
+    CSRGraph& network = getFlowNetwork();
+
+    // every query is read first, so that the failure scenarios of all of them are evaluated together
+    vector<pair<int,vector<string>>> queries;
+    string line;
+    for (int lineNumber = 1; getline(in, line); lineNumber++){
+        if (!isQuery(line)) continue;
+        queries.emplace_back(lineNumber, splitQuery(line));
+    }
+
+    vector<string> errors(queries.size());
+    vector<int> counts(queries.size(), 0);
+    vector<int> scenarioOf(queries.size(), -1);
+    vector<FailureScenarioEngine::Scenario> scenarios;
+    for (size_t i = 0; i < queries.size(); i++){
+        const vector<string>& q = queries[i].second;
+        if (q[0] != "failure" && q[0] != "section") continue;
+        FailureScenarioEngine::Scenario scenario;
+        errors[i] = parseScenario(q, counts[i], scenario);
+        if (!errors[i].empty()) continue;
+        scenarioOf[i] = (int) scenarios.size();
+        scenarios.push_back(scenario);
+    }
+    vector<vector<StationImpact>> impacts;
+    if (!scenarios.empty()){
+        impacts = FailureScenarioEngine(network,driver).evaluate(scenarios);
+    }
+
+    int failed = 0;
+    for (size_t i = 0; i < queries.size(); i++){
+        const vector<string>& q = queries[i].second;
+        ostringstream result;
+        string error;
+        if (scenarioOf[i] != -1) writeImpacts(impacts[scenarioOf[i]], counts[i], result);
+        else if (q[0] == "failure" || q[0] == "section") error = errors[i];
+        else error = answerQuery(q, workspace, result);
+
+        out << queries[i].first << '\t';
+        if (error.empty()) out << "ok" << result.str() << '\n';
+        else {
+            out << "error\t" << error << '\n';
+            failed++;
+        }
+    }
+    out.flush();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << queries.size() << " queries answered in " << fixed << setprecision(3) << seconds * 1000 << " ms ("
+         << setprecision(1) << (seconds > 0 ? queries.size() / seconds : 0.0) << " queries per second), "
+         << failed << " failed\n";
+    if (Instrumentation::enabled) {
+        Instrumentation::writeJson(cerr, Instrumentation::snapshot() - before);
+        cerr << '\n';
+    }
+    return failed;
+}
+
+string TrainManager::answerQuery(const vector<string>& query, FlowWorkspace& ws, ostream& result) {
+    CSRGraph& network = getFlowNetwork();
+    const string& kind = query[0];
+    if (kind == "maxflow" || kind == "mincost"){
+        int s = query.size() == 3 ? findStation(query[1]) : -1;
+        int t = query.size() == 3 ? findStation(query[2]) : -1;
+        if (query.size() != 3) return "expected two stations";
+        if (s == -1 || t == -1) return "unknown station " + query[s == -1 ? 1 : 2];
+        if (s == t) return "same source and target";
+        if (kind == "maxflow") result << '\t' << network.maxFlow(ws,s,t,engine);
+        else {
+            FlowWithCost res = network.minCostMaxFlow(ws,s,t);
+            result << '\t' << res.flow << '\t' << res.cost;
+        }
+        return "";
+    }
+
+    // the other queries read and fill results shared by every thread, and run on the worker threads of the driver
+    lock_guard<mutex> lock(queryMutex);
+    if (kind == "inflow"){
+        int t = query.size() == 2 ? findStation(query[1]) : -1;
+        if (query.size() != 2) return "expected a station";
+        if (t == -1) return "unknown station " + query[1];
+        result << '\t' << getMaxFlowToSingleStation(network.getVertex(t));
+    }
+    else if (kind == "municipalities" || kind == "districts"){
+        int k;
+        if (query.size() != 2 || !parseCount(query[1], k)) return "expected k";
+        auto ranking = kind == "municipalities"
+                ? rankGroups(top_mun,&Station::getMunicipalityId,Station::getMunicipalityPool())
+                : rankGroups(top_dis,&Station::getDistrictId,Station::getDistrictPool());
+        for (size_t j = 0; j < (size_t) k && j < ranking.size(); j++){
+            result << '\t' << ranking[j].first << '\t' << ranking[j].second;
+        }
+    }
+    else if (kind == "failure" || kind == "section"){
+        int k;
+        FailureScenarioEngine::Scenario scenario;
+        string error = parseScenario(query, k, scenario);
+        if (!error.empty()) return error;
+        writeImpacts(FailureScenarioEngine(network,driver).evaluate({scenario})[0], k, result);
+    }
+    else {
+        return "unknown query " + kind;
+    }
+    return "";
+}
+
+void TrainManager::prepareQueries() {
+    getFlowNetwork();
+}
+
+bool TrainManager::isQuery(string& line) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return !line.empty() && line[0] != '#';
+}
+
+vector<string> TrainManager::splitQuery(const string& line) {
+    vector<string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t end = line.find('\t', start);
+        fields.push_back(line.substr(start, end == string::npos ? string::npos : end - start));
+        if (end == string::npos) return fields;
+        start = end + 1;
+    }
+}
+
+int TrainManager::findStation(const string& name) {
+    Vertex* v = trainNetwork.findVertexByName(name);
+    return v == nullptr ? -1 : getFlowNetwork().indexOf(v);
+}
+
+string TrainManager::parseScenario(const vector<string>& query, int& k, FailureScenarioEngine::Scenario& scenario) {
+    if (query.size() < 4 || !parseCount(query[1], k)) return "expected k and at least two stations";
+    vector<int> stops;
+    for (size_t j = 2; j < query.size(); j++){
+        stops.push_back(findStation(query[j]));
+        if (stops.back() == -1) return "unknown station " + query[j];
+    }
+
+    CSRGraph& network = getFlowNetwork();
+    if (query[0] == "section"){
+        scenario = FailureScenarioEngine::lineSection(stops);
+    }
+    else if (stops.size() % 2 != 0){
+        return "expected pairs of stations";
+    }
+    else {
+        for (size_t j = 0; j < stops.size(); j += 2) scenario.emplace_back(stops[j], stops[j + 1]);
+    }
+    for (auto& segment : scenario){
+        if (network.findArc(segment.first, segment.second) == -1){
+            return "no segment between " + network.getVertex(segment.first)->getStation().getName() + " and " +
+                    network.getVertex(segment.second)->getStation().getName();
+        }
+    }
+    return "";
+}
+
+void TrainManager::writeImpacts(const vector<StationImpact>& impacts, int k, ostream& result) {
+    CSRGraph& network = getFlowNetwork();
+    for (size_t j = 0; j < (size_t) k && j < impacts.size(); j++){
+        result << '\t' << network.getVertex(impacts[j].station)->getStation().getName()
+               << '\t' << impacts[j].before << '\t' << impacts[j].after;
+    }
+}
+
 string TrainManager::getAnswer() {
     string answer;
     cin >> answer;
@@ -350,26 +580,200 @@ void TrainManager::calculateMaxFlowFromNetworkToSingleStation() {
 }
 
 unsigned long TrainManager::getMaxFlowToSingleStation(Vertex * v) {
-    vector<Vertex*> leafNodes ;
-    trainNetwork.BFS(v,leafNodes);
-    if (leafNodes.empty()){
-        return 0;
+    InflowSourceTable& sources = getInflowSources();
+    CSRGraph& network = getFlowNetwork();
+    int target = network.indexOf(v);
+    if (stationInflows[target] == ULONG_MAX){
+        vector<int> leafNodes;
+        sources.find(network,workspace,target,leafNodes);
+        stationInflows[target] = leafNodes.empty() ? 0 : network.maxFlow(workspace,leafNodes,target,engine);
     }
+    return stationInflows[target];
+}
 
-    Station newStation ("temp","p","","",leafNodes[0]->getStation().getLine());
-    trainNetwork.addVertex(newStation);
+void TrainManager::chooseFlowEngine() {
+    cout << "Which algorithm should be used to calculate maximum flows? (current: " << getEngineName(engine) << ")\n"
+         << "1- Edmonds-Karp\n"
+         << "2- Dinic\n"
+         << "3- Push-relabel\n";
+    string choice = getAnswer();
+    if (choice == "1") engine = FlowEngine::EDMONDS_KARP;
+    else if (choice == "2") engine = FlowEngine::DINIC;
+    else if (choice == "3") engine = FlowEngine::PUSH_RELABEL;
+    else {
+        cout << "Invalid Input\n";
+        return;
+    }
+    cout << "Using " << getEngineName(engine) << ".\n";
+}
 
-    for (Vertex* node : leafNodes){
-        Station ml = node->getStation();
-        trainNetwork.addEdge(newStation,ml,INT_MAX,"NO SERVICE");
+string TrainManager::getEngineName(FlowEngine flowEngine) {
+    switch (flowEngine) {
+        case FlowEngine::DINIC: return "Dinic";
+        case FlowEngine::PUSH_RELABEL: return "Push-relabel";
+        default: return "Edmonds-Karp";
     }
+}
 
-    Vertex* newVertex = trainNetwork.findVertex(newStation);
-    unsigned long p = trainNetwork.edmondsKarp(newVertex,v);
-    trainNetwork.removeVertex(newStation);
-    return p;
+const Graph &TrainManager::getNetwork() const {
+    return trainNetwork;
 }
 
+CSRGraph &TrainManager::getFlowNetwork() {
+    if (flowNetworkVersion != trainNetwork.getVersion()) {
+        flowNetwork = CSRGraph(trainNetwork);
+        flowNetworkVersion = trainNetwork.getVersion();
+    }
+    return flowNetwork;
+}
 
+int TrainManager::getNumPairBlocks() {
+    return std::max(1, std::min<int>(getFlowNetwork().getNumVertex(), 16 * driver.getNumThreads()));
+}
 
+InflowSourceTable &TrainManager::getInflowSources() {
+    if (inflowSourcesVersion != trainNetwork.getVersion()) {
+        inflowSources = InflowSourceTable(getFlowNetwork().getNumVertex());
+        stationInflows.assign(inflowSources.getNumVertex(),ULONG_MAX);
+        inflowSourcesVersion = trainNetwork.getVersion();
+    }
+    return inflowSources;
+}
 
+PairFlowMatrix &TrainManager::getPairFlows() {
+    GomoryHuTree& tree = getCutTree();
+    if (pairFlowsVersion != trainNetwork.getVersion()) {
+        pairFlows = PairFlowMatrix(getFlowNetwork(),tree,driver);
+        pairFlowsVersion = trainNetwork.getVersion();
+    }
+    return pairFlows;
+}
+
+void TrainManager::discardOutdatedReports() {
+    if (reportsVersion != trainNetwork.getVersion()) {
+        pairsOfStationsWithBiggestMaxFlow.clear();
+        top_mun.clear();
+        top_dis.clear();
+        reportsVersion = trainNetwork.getVersion();
+    }
+}
+
+void TrainManager::visitPairFlows(int blocks, const function<void(int, int, int, unsigned long)>& visit) {
+    PairFlowMatrix& flows = getPairFlows();
+    int n = flows.getNumVertex();
+    driver.run(blocks, [&](int b, FlowWorkspace&){
+        for (int i = (long) n * b / blocks; i < (long) n * (b + 1) / blocks; i++){
+            for (int j = i+1; j < n; j++){
+                visit(b, i, j, flows.get(i,j));
+            }
+        }
+    });
+}
+
+void TrainManager::sumPairFlows(map<string, unsigned long>& totals, unsigned int (Station::*group)() const,
+                                const StringPool& names) {
+    CSRGraph& network = getFlowNetwork();
+    int n = network.getNumVertex();
+    // the identifiers of the groups are dense, so they index the totals directly
+    vector<unsigned int> groupOf(n);
+    vector<char> used(names.size(), false);
+    for (int i = 0; i < n; i++){
+        groupOf[i] = (network.getVertex(i)->getStation().*group)();
+        used[groupOf[i]] = true;
+    }
+    int blocks = getNumPairBlocks();
+    vector<vector<unsigned long>> blockTotals(blocks, vector<unsigned long>(names.size(), 0));
+    visitPairFlows(blocks, [&](int b, int i, int j, unsigned long temp){
+        blockTotals[b][groupOf[i]] += temp;
+        blockTotals[b][groupOf[j]] += temp;
+    });
+    if (n < 2) return;
+    for (unsigned int g = 0; g < names.size(); g++){
+        if (!used[g]) continue;
+        unsigned long total = 0;
+        for (int b = 0; b < blocks; b++){
+            total += blockTotals[b][g];
+        }
+        totals[names.get(g)] += total;
+    }
+}
+
+GomoryHuTree &TrainManager::getCutTree() {
+    CSRGraph& network = getFlowNetwork();
+    if (cutTreeVersion != trainNetwork.getVersion()) {
+        cutTree = GomoryHuTree(network,engine,driver);
+        cutTreeVersion = trainNetwork.getVersion();
+    }
+    return cutTree;
+}
+
+void TrainManager::benchmarkFlowEngines() {
+    benchmarkIngestion();
+    cout << "The maximum flow between two stations and the maximum flow arriving at the target station will be "
+            "calculated with every algorithm.\n";
+    auto stations_input = getStationsFromUser();
+    Vertex* s = stations_input.first;
+    Vertex* t = stations_input.second;
+    if (s == nullptr || t == nullptr || s == t){
+        cout << "Invalid station!\n";
+        return;
+    }
+    CSRGraph& network = getFlowNetwork();
+    int source = network.indexOf(s);
+    int target = network.indexOf(t);
+    vector<int> leafNodes;
+    getInflowSources().find(network,workspace,target,leafNodes);
+
+    const FlowEngine engines[] = {FlowEngine::EDMONDS_KARP, FlowEngine::DINIC, FlowEngine::PUSH_RELABEL};
+    cout << left << setw(15) << "Algorithm" << setw(12) << "Max flow" << setw(16) << "Time (us)"
+         << setw(12) << "Inflow" << "Time (us)\n";
+    for (FlowEngine e : engines){
+        unsigned long flow = 0, inflow = 0;
+        double flowTime = timeQuery([&](){ flow = network.maxFlow(workspace,source,target,e); });
+        double inflowTime = timeQuery([&](){ inflow = network.maxFlow(workspace,leafNodes,target,e); });
+        cout << left << setw(15) << getEngineName(e) << setw(12) << flow << setw(16) << fixed << setprecision(2)
+             << flowTime << setw(12) << inflow << inflowTime << '\n';
+    }
+}
+
+void TrainManager::benchmarkIngestion() {
+    cout << left << setw(32) << "CSV file" << setw(12) << "Records" << setw(16) << "Time (us)" << setw(12) << "MB/s"
+         << "Records/s\n";
+    for (const string& file : {stationsFile, networkFile}){
+        size_t records = 0, bytes = 0;
+        double time = timeQuery([&](){
+            CsvReader csv;
+            vector<string_view> fields;
+            csv.open(file);
+            bytes = csv.getSize();
+            records = 0;
+            while (csv.readRecord(fields)) records++;
+        });
+        // bytes per microsecond are megabytes per second
+        cout << left << setw(32) << file << setw(12) << records << setw(16) << fixed << setprecision(2) << time
+             << setw(12) << bytes / time << records / time * 1e6 << '\n';
+    }
+    cout << '\n' << left << setw(32) << "Allocator" << setw(12) << "Live" << setw(16) << "Slots" << setw(12)
+         << "Slabs" << "Reused\n";
+    auto printPool = [](const string& name, size_t live, size_t slots, size_t slabs, size_t reused){
+        cout << left << setw(32) << name << setw(12) << live << setw(16) << slots << setw(12) << slabs << reused << '\n';
+    };
+    const auto& vertices = trainNetwork.getVertexPoolStats();
+    const auto& edges = trainNetwork.getEdgePoolStats();
+    printPool("Vertices", vertices.live, vertices.slots, vertices.slabAllocations, vertices.reused);
+    printPool("Edges", edges.live, edges.slots, edges.slabAllocations, edges.reused);
+    cout << '\n';
+}
+
+double TrainManager::timeQuery(const function<void()>& query) {
+    // repeat the query until the measurement is long enough to be meaningful
+    int runs = 0;
+    auto start = chrono::steady_clock::now();
+    chrono::duration<double, micro> elapsed(0);
+    while (runs < 1000 && (runs < 3 || elapsed.count() < 200000)){
+        query();
+        runs++;
+        elapsed = chrono::steady_clock::now() - start;
+    }
+    return elapsed.count() / runs;
+}
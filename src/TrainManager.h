@@ -7,108 +7,221 @@
 
 #include <unordered_map>
 #include <map>
+#include <climits>
+#include <functional>
+#include <mutex>
 #include "../data_structures/Graph.h"
-
-class MyHashFunction {
-public:
-    size_t operator()(const Network& p) const
-    {
-        return p.getStationA().length() + p.getStationB().length() + p.getService().length() + p.getCapacity();
-    }
-};
+#include "../data_structures/CSRGraph.h"
+#include "../data_structures/GomoryHuTree.h"
+#include "../data_structures/ParallelFlowDriver.h"
+#include "../data_structures/PairFlowMatrix.h"
+#include "../data_structures/FailureScenarioEngine.h"
+#include "../data_structures/InflowSourceTable.h"
 
 class TrainManager {
 public:
     /**
      * Constructs a TrainManager object and loads stations and networks data.
-     * The constructor loads stations and networks data from their respective data files and
-     * initializes the TrainManager object with them.
+     * The constructor loads the network from its binary snapshot when there is an up to date one, otherwise it
+     * loads stations and networks data from their respective data files and writes the snapshot for the next start.
      */
     TrainManager();
+    /**
+     * Constructs a TrainManager whose network is read from other files, for tools such as the benchmarks.
+     * Only the costs of the services are loaded, the network is empty until LoadStations and LoadNetworks, or
+     * LoadSnapshot, are called.
+     * @param stationsFile Path of the CSV file of the stations
+     * @param networkFile Path of the CSV file of the segments
+     */
+    TrainManager(string stationsFile, string networkFile);
+    /**
+     * Loads the stations and the segments from a binary snapshot written by NetworkSnapshot::write from the CSV files
+     * of this TrainManager.
+     * The snapshot is mapped into memory and its records are copied into the graph directly, without parsing or
+     * looking up any station. Nothing is loaded if the snapshot is missing, invalid or older than the CSV files.
+     * Time complexity: O(V + E), where V is the number of stations and E the number of segments.
+     * @param path Path of the snapshot
+     * @return true if the network was loaded from the snapshot
+     */
+    bool LoadSnapshot(const string& path);
+    /**
+     * Loads the cost of every service from the `services.csv` file in the `../resources` directory, made of lines
+     * with the name of a service and its cost. The costs are used by the algorithms that look for cheap paths.
+     * Services that are not in the file keep their default cost, as they do when the file does not exist.
+     * Negative costs are ignored, the minimum cost flow needs non-negative ones.
+     * The time complexity is O(n), where n is the number of services in the file.
+     */
+    void LoadServices();
     /**
      * Loads station data from a file and initializes Station objects.
      * The method reads station data from a CSV file and initializes Station objects with the data.
      * The Station objects are then added to the `stations` map and the `trainNetwork` graph as vertices.
-     * This method assumes the station data file is located in the `../resources` directory and
-     * named `stations.csv`.
+     * The station data file is `stations2.csv` in the `../resources` directory, unless other files were given to
+     * the constructor.
      * The time complexity is O(n), where n is the number of stations in the file.
      */
     void LoadStations();
     /**
-     * Loads the train network connections from the "network.csv" file and creates a bidirectional edge
-     * between the two stations, using the capacity and service as edge weights.
-     * O(n * log n), where n is the number of network connections in the file. This is
-     * because we are inserting each connection into a map, which has a logarithmic time
-     * complexity for insertions. Since we are doing this n times, the overall time
-     * complexity is O(n * log n).
+     * Loads the train network connections from the "network2.csv" file, or the one given to the constructor, and
+     * creates a bidirectional edge between the two stations, using the capacity and service as edge weights.
+     * A connection between two stations that are already connected, in either direction, is ignored.
+     * O(n) on average, where n is the number of network connections in the file, since the stations
+     * and the existing segments are found through hash indexes.
      */
     void LoadNetworks();
+    /**
+     * @return The train network, as loaded from the files
+     */
+    const Graph& getNetwork() const;
     /**
      * Calculates the maximum number of trains that can travel between two stations based on the current network.
      * Asks the user to input the source and target stations.
-     * Uses the Edmonds-Karp algorithm to calculate the maximum flow between the two stations.
+     * Uses the maximum flow algorithm chosen with chooseFlowEngine (Edmonds-Karp unless another one was chosen),
+     * which the batch and server queries use as well, to calculate the maximum flow between the two stations.
      * Outputs the maximum flow to the console.
-     * Time complexity is O(|V||E|²)
+     * Time complexity is O(|V||E|²) with Edmonds-Karp, O(|V|²|E|) with Dinic and O(|V|²√|E|) with push-relabel
      */
     void maxFlowOfTrains();
     /**
      * This method prompts the user for the name of a station and calculates the maximum
      * number of trains that can simultaneously arrive at that station.
-     * The method uses the Ford-Fulkerson algorithm to compute the maximum flow from the
+     * The method uses the maximum flow algorithm chosen with chooseFlowEngine to compute the maximum flow from the
      * source node (the "network" vertex) to the given station node (the "single" vertex).
      * If the given station name is invalid, the method outputs an error message.
      *
-     * Time complexity: O(V*E^2) for the Ford-Fulkerson algorithm (where V is the number of vertices
-     * in the graph and E is the number of edges).
+     * Time complexity: O(V*E^2) with Edmonds-Karp, O(V^2*E) with Dinic and O(V^2*sqrt(E)) with push-relabel (where V
+     * is the number of vertices in the graph and E is the number of edges).
      */
     void calculateMaxFlowFromNetworkToSingleStation();
     /**
      * Finds the pairs of stations that have the greatest maximum flow of trains between them.
      * The function first tries to find the maximum flow between the stations already saved in the
-     * `pairsOfStationsWithBiggestMaxFlow` attribute. If it is empty, it will calculate the maximum flow
-     * between all pairs of stations and update the attribute accordingly. The function prints the maximum
-     * flow found and the names of the stations in the pairs with the biggest maximum flow.
-     * Time complexity: O(n^3), where n is the number of stations.
+     * `pairsOfStationsWithBiggestMaxFlow` attribute. If it is empty, it will read the maximum flow
+     * between all pairs of stations from the pair flow matrix and update the attribute accordingly. The function prints
+     * the maximum flow found and the names of the stations in the pairs with the biggest maximum flow.
+     * Time complexity: O(n^2) to read the pair flow matrix, where n is the number of stations, plus the time to
+     * compute the matrix if no other report did it yet.
      */
     void stations_most_amount_trains();
     /**
      * Calculates the maximum flow with minimum cost between two user-input stations using the network's current edge costs.
-     * Uses the Bellman-Ford algorithm to find the cheapest path and the Ford-Fulkerson algorithm to calculate the maximum flow.
+     * Every train crossing a segment costs the cost of its service, and the cheapest augmenting paths are found with
+     * Dijkstra's algorithm on costs reduced by potentials (see CSRGraph::minCostMaxFlow). Prints the flow and its cost.
      * The edge costs are assumed to be non-negative.
      * If the input stations are invalid, the function will print an error message and return.
+     * Time complexity: O(F * E * log(V)), where F is the number of augmenting paths.
      */
     void calculateMaxFlowWithMinimumCost();
     /**
      * Removes a segment from the train network and allows the user to perform various operations
      * on the modified network, such as calculating the maximum number of trains that can travel between two
      * given stations, calculating the top-k most affected stations per segment, and undoing changes to the network.
+     * The top-k is computed by a FailureScenarioEngine, for every deleted segment alone and, when there are several,
+     * for all of them failing together; the stations are evaluated in parallel and the network is not modified.
      * The worst-case time complexity of this function is O(N*M*log(N)), where N is the number of vertices in the graph and M is the number of edges in the graph. This is because the function performs operations such as removing edges from the graph, calculating maximum flow, and sorting vertices, all of which have time complexity proportional to N and M.
      */
     void useSubGraph();
     /**
      * This function calculates and prints the top-k municipalities with the highest number of passengers traveling through them.
-     * It uses the Edmonds-Karp algorithm to calculate the maximum flow between each pair of stations in the network,
+     * It reads the maximum flow between each pair of stations in the network from the pair flow matrix,
      * and then aggregates the flow for each municipality. Finally, it sorts the municipalities by their total flow in decreasing order and prints the top-k results.
-     * Time complexity: O(|V|^2 * E * log E), where |V| is the number of vertices in the graph, and E is the number of edges in the graph.
+     * Time complexity: O(|V|^2), where |V| is the number of vertices in the graph, plus the time to compute the pair flow matrix if no other report did it yet.
      */
     void top_municipalities();
     /**
      * Calculates the top k districts with the highest number of passengers transported between them.
      * This method prompts the user to input the number of top districts to calculate.
      * It then iterates over all stations in the network and adds their district to a map if it doesn't already exist.
-     * It then calculates the maximum flow between each pair of stations in the network and accumulates the flow in the corresponding district's value in the map.
+     * It then reads the maximum flow between each pair of stations in the network from the pair flow matrix and accumulates the flow in the corresponding district's value in the map.
      * Finally, it sorts the districts in decreasing order by their accumulated flow and prints the top k districts with their respective flow values.
-     * Time complexity: O(V^2 E log E) where V is the number of vertices in the network and E is the number of edges.
+     * Time complexity: O(V^2) where V is the number of vertices in the network, plus the time to compute the pair flow matrix if no other report did it yet.
      */
     void top_districts();
+    /**
+     * Answers the queries read from a stream without asking the user anything, one query per line made of fields
+     * separated by tabs, and writes one tab separated line per query with its number, "ok" or "error" and its result:
+     * - maxflow, source, target: the maximum flow between two stations;
+     * - inflow, station: the maximum flow arriving at a station (see getMaxFlowToSingleStation);
+     * - mincost, source, target: the maximum flow between two stations and its minimum cost;
+     * - municipalities or districts, k: the k groups with the most transportation needs, as name and total pairs;
+     * - failure, k, station, station, ...: the k stations most affected when the segments between every pair of
+     *   stations given fail together, as name, flow before and flow after triples;
+     * - section, k, station, station, ...: the same, for the segments between consecutive stations of a line.
+     * Empty lines and lines starting with '#' are skipped. The network is loaded once and every query shares its
+     * compressed copy, workspace and cached reports, and the failure scenarios of every query are evaluated in a
+     * single pass of a FailureScenarioEngine. The number of queries answered per second is written to cerr.
+     * Time complexity: the sum of the one of every query.
+     * @param in Stream the queries are read from
+     * @param out Stream the results are written to
+     * @return The number of queries that could not be answered
+     */
+    int runBatch(istream& in, ostream& out);
+    /**
+     * Answers a single query, given as the fields of a line of runBatch. The flows between two stations run on the
+     * workspace given, so that several threads can answer them at the same time, while the other queries, which
+     * share cached results and the worker threads, are answered one at a time. The network must not be modified
+     * while queries are being answered.
+     * Time complexity: the one of the query.
+     * @param query The fields of the query, the first one being its kind
+     * @param ws Workspace of the calling thread
+     * @param result Stream the fields of the result are written to, each one preceded by a tab
+     * @return An empty string if the query was answered, otherwise why it could not be
+     */
+    string answerQuery(const vector<string>& query, FlowWorkspace& ws, ostream& result);
+    /**
+     * Builds the compressed copy of the network the queries run on, which must be done before answerQuery is called
+     * from several threads at once, since none of them builds it then.
+     * Time complexity: O(1), or O(V + E) when it has to be built.
+     */
+    void prepareQueries();
+    /**
+     * Removes the carriage return that ends a line read from a file or a client, and tells whether it holds a query,
+     * empty lines and lines starting with '#' being skipped by runBatch and the server.
+     * Time complexity: O(1).
+     * @param line A line without its newline
+     * @return true if the line is a query
+     */
+    static bool isQuery(string& line);
+    /**
+     * Time complexity: O(n), n being the length of the line.
+     * @param line A query, made of fields separated by tabs
+     * @return The fields of the query, there is always at least one
+     */
+    static vector<string> splitQuery(const string& line);
 
     /**
-     * Calculates the maximum flow of trains that can travel to a single station
+     * Calculates the maximum flow of trains that can travel to a single station, coming from the leaves of a BFS
+     * through the STANDARD segments starting at that station. The leaves are connected to a virtual super-source,
+     * so the network is not modified. The leaves are read from the inflow source table and the result is kept until
+     * the network changes, so asking again for the same station costs nothing.
      * @param v The vertex representing the station to calculate the maximum flow to
      * @return The maximum flow of trains that can travel to the station
-     * Time complexity: O((V+E) * E^2), where V is the number of vertices in the train network, E is the number of edges
+     * Time complexity: O(V * E^2) with Edmonds-Karp the first time, where V is the number of vertices in the train network, E is the number of edges, O(1) after that
      */
     unsigned long getMaxFlowToSingleStation(Vertex* v);
+    /**
+     * Asks the user which algorithm should be used by every maximum flow calculation from now on.
+     * Time complexity: O(1).
+     */
+    void chooseFlowEngine();
+    /**
+     * Asks the user for two stations and times every maximum flow algorithm on the same queries: the maximum flow
+     * between the two stations and the maximum flow that can arrive at the second one. The average time of each
+     * query is printed next to its result. The throughput of the CSV ingestion is printed first.
+     * Time complexity: the one of the slowest algorithm, times the number of repetitions.
+     */
+    void benchmarkFlowEngines();
+    /**
+     * Times the reading of every record of the CSV files the network is loaded from and prints, for each file, the
+     * number of records, the average time of a full pass and the throughput in megabytes and records per second.
+     * Time complexity: O(n) per pass, n being the size of the files, times the number of repetitions.
+     */
+    void benchmarkIngestion();
+    /**
+     * @param flowEngine A maximum flow algorithm
+     * @return The name of the algorithm, to show to the user
+     */
+    static string getEngineName(FlowEngine flowEngine);
     /**
      * Reads a string input from the user and returns it after clearing any input errors.
      * @return A string input from the user.
@@ -130,12 +243,125 @@ public:
      */
     pair<Vertex*,Vertex*> getStationsFromUser();
 private:
+    /**
+     * Returns the compressed copy of the train network used by the flow algorithms, rebuilding it first if
+     * segments or stations were added or removed since it was last built.
+     * Time complexity: O(1), or O(V + E) when it has to be rebuilt.
+     * @return The CSR representation of the current train network
+     */
+    CSRGraph& getFlowNetwork();
+    /**
+     * Returns the flow equivalent tree of the train network, rebuilding it first if the network changed since it
+     * was last built. The maximum flow between any pair of stations can be read from it.
+     * Time complexity: O(1), or V maximum flow computations when it has to be rebuilt.
+     * @return The Gomory-Hu tree of the current train network
+     */
+    GomoryHuTree& getCutTree();
+    /**
+     * Returns the sources of the flow arriving at the stations, emptying the table first if the network changed
+     * since it was last built. Also forgets the flows computed by getMaxFlowToSingleStation in that case. The sources
+     * of a station are only found, and kept, the first time it is asked for.
+     * Time complexity: O(1), or O(V) when it has to be emptied.
+     * @return The inflow source table of the current train network
+     */
+    InflowSourceTable& getInflowSources();
+    /**
+     * Returns the maximum flow between every pair of stations, shared by every report over the pairs of stations.
+     * It is filled again when the network changed since it was last computed, for instance because segments were
+     * deleted in useSubGraph.
+     * Time complexity: O(1), or the one of getCutTree plus O(V^2) when it has to be recomputed.
+     * @return The pair flow matrix of the current train network
+     */
+    PairFlowMatrix& getPairFlows();
+    /**
+     * Clears the results saved by the reports over the pairs of stations if the network changed since they were
+     * computed, so that they are read again from the new pair flow matrix.
+     * Time complexity: O(1) when nothing changed.
+     */
+    void discardOutdatedReports();
+    /**
+     * @return The number of blocks the rows of station pairs are split into, so that each worker thread gets
+     * several of them
+     */
+    int getNumPairBlocks();
+    /**
+     * Calls visit(block, i, j, flow) for every pair of stations i < j, flow being their maximum flow read from the
+     * pair flow matrix. The rows of pairs are split into blocks processed in parallel by the worker threads, so
+     * visit must only update state belonging to its block.
+     * Time complexity: O(V^2) divided by the number of threads.
+     * @param blocks Number of blocks, usually getNumPairBlocks()
+     * @param visit Function called for every pair
+     */
+    void visitPairFlows(int blocks, const function<void(int, int, int, unsigned long)>& visit);
+    /**
+     * Adds to every group of stations (municipality, district...) the maximum flow of every pair of stations it is
+     * part of. Each block of pairs sums into its own totals, which are then added in order.
+     * Time complexity: O(V^2) divided by the number of threads.
+     * @param totals The map from the name of each group to its total
+     * @param group Getter of the identifier of the group of a station
+     * @param names Pool of the names of the groups
+     */
+    void sumPairFlows(map<string, unsigned long>& totals, unsigned int (Station::*group)() const,
+                      const StringPool& names);
+    /**
+     * Fills the totals of every group of stations from the pair flow matrix, unless the reports are up to date, and
+     * ranks them.
+     * Time complexity: O(G log G), G being the number of groups, plus the one of sumPairFlows when they are filled.
+     * @param totals The map from the name of each group to its total, top_mun or top_dis
+     * @param group Getter of the identifier of the group of a station
+     * @param names Pool of the names of the groups
+     * @return The groups and their totals, by decreasing total
+     */
+    vector<pair<string,unsigned long>> rankGroups(map<string, unsigned long>& totals,
+                                                  unsigned int (Station::*group)() const, const StringPool& names);
+    /**
+     * Time complexity: O(n) on average, n being the length of the name.
+     * @param name Name of a station
+     * @return The index of the station in the flow network, -1 if there is no station with that name
+     */
+    int findStation(const string& name);
+    /**
+     * Reads the failure scenario of a failure or section query of runBatch.
+     * Time complexity: O(n * d), n being the number of stations of the query and d their degree.
+     * @param query The fields of the query
+     * @param k Where the number of stations asked for is stored
+     * @param scenario Where the segments that fail are stored
+     * @return An empty string if the query is valid, otherwise what is wrong with it
+     */
+    string parseScenario(const vector<string>& query, int& k, FailureScenarioEngine::Scenario& scenario);
+    /**
+     * Writes the name, flow before and flow after of the k stations most affected by a failure scenario.
+     * Time complexity: O(k).
+     */
+    void writeImpacts(const vector<StationImpact>& impacts, int k, ostream& result);
+    /**
+     * Runs a query repeatedly, at least 3 and at most 1000 times, until 200 milliseconds have passed.
+     * @param query The query to time
+     * @return The average duration of the query in microseconds
+     */
+    static double timeQuery(const function<void()>& query);
+
+    string stationsFile;
+    string networkFile;
     Graph trainNetwork;
+    CSRGraph flowNetwork;
+    unsigned long flowNetworkVersion = ULONG_MAX;
+    FlowEngine engine = FlowEngine::EDMONDS_KARP;
+    GomoryHuTree cutTree;
+    FlowWorkspace workspace;
+    ParallelFlowDriver driver;
+    unsigned long cutTreeVersion = ULONG_MAX;
+    PairFlowMatrix pairFlows;
+    unsigned long pairFlowsVersion = ULONG_MAX;
+    InflowSourceTable inflowSources;
+    vector<unsigned long> stationInflows;   // flow arriving at every station, ULONG_MAX until it is computed
+    unsigned long inflowSourcesVersion = ULONG_MAX;
+    unsigned long reportsVersion = ULONG_MAX;
     unordered_map<std::string,Station> stations;
-    unordered_map<Network,double,MyHashFunction> networks;
     vector<pair<Vertex*,Vertex*>> pairsOfStationsWithBiggestMaxFlow;
     map<std::string,unsigned long> top_mun;
     map<std::string, unsigned long> top_dis;
+    mutex queryMutex;   // held by answerQuery for the queries that share state
 
 
 };
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../data_structures/CSRGraph.h"
+#include "../data_structures/FailureScenarioEngine.h"
+#include "../src/NetworkGenerator.h"
+#include "../src/TrainManager.h"
+using namespace std;
+
+/*
+ * Checks the incremental maximum flow of CSRGraph against a maximum flow computed from scratch: random graphs go
+ * through random sequences of segments removed, restored and given other capacities, and of sources replaced, and
+ * after every step the repaired flow must be the one of a graph built without the removed segments. Then the failure
+ * scenarios of generated networks, every segment alone and some sections of lines, must change the inflow of the
+ * same stations as the networks built without their segments.
+ *
+ *   incremental_flow_test [--graphs N] [--steps N] [--networks N]
+ */
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const string& what) {
+        if (ok) return;
+        failures++;
+        cerr << "FAILED: " << what << endl;
+    }
+
+    /**
+     * Segment between two vertices, smallest index first.
+     */
+    pair<int, int> segmentOf(int u, int v) {
+        return {min(u, v), max(u, v)};
+    }
+
+    /**
+     * Builds a random graph of n stations on one or two lines. Most segments go both ways, some only one way, and
+     * some are ALFA PENDULAR.
+     */
+    void buildRandomGraph(Graph& g, int n, mt19937_64& rng) {
+        int lines = 1 + (int) (rng() % 2);
+        vector<Vertex*> vertices;
+        for (int i = 0; i < n; i++) {
+            string name = "Station " + to_string(i);
+            vertices.push_back(g.appendVertex(Station(name, "D", "M", "T", "Line " + to_string(i % lines))));
+        }
+        set<pair<int, int>> used;
+        int m = n + (int) (rng() % (2 * n));
+        for (int k = 0; k < m; k++) {
+            // the first n - 1 segments make a spanning tree, so most pairs are connected
+            int u = k < n - 1 ? k + 1 : (int) (rng() % n);
+            int v = k < n - 1 ? (int) (rng() % (k + 1)) : (int) (rng() % n);
+            if (u == v || !used.insert(segmentOf(u, v)).second) continue;
+            int w = 1 + (int) (rng() % 9);
+            string service = rng() % 5 == 0 ? "ALFA PENDULAR" : "STANDARD";
+            Edge* e = g.appendEdge(vertices[u], vertices[v], w, service);
+            if (rng() % 6 != 0) g.pairEdges(e, g.appendEdge(vertices[v], vertices[u], w, service));
+        }
+    }
+
+    /**
+     * Builds a copy of g without some of its segments and with the capacity of others changed. The vertices keep
+     * their indexes.
+     */
+    void copyGraph(const Graph& g, Graph& copy, const set<pair<int, int>>& removed,
+                   const map<pair<int, int>, int>& capacities) {
+        vector<Vertex*> vertices = g.getVertexSet();
+        map<const Vertex*, Vertex*> vertexOf;
+        map<const Vertex*, int> indexOf;
+        for (size_t i = 0; i < vertices.size(); i++) {
+            vertexOf[vertices[i]] = copy.appendVertex(vertices[i]->getStation());
+            indexOf[vertices[i]] = i;
+        }
+        map<const Edge*, Edge*> edgeOf;
+        for (Vertex* v : vertices) {
+            for (Edge* e : v->getAdj()) {
+                auto segment = segmentOf(indexOf[e->getOrig()], indexOf[e->getDest()]);
+                if (removed.count(segment)) continue;
+                auto it = capacities.find(segment);
+                int w = it == capacities.end() ? e->getWeight() : it->second;
+                edgeOf[e] = copy.appendEdge(vertexOf[e->getOrig()], vertexOf[e->getDest()], w, e->getService());
+                if (e->getReverse() != nullptr && edgeOf.count(e->getReverse())) {
+                    copy.pairEdges(edgeOf[e->getReverse()], edgeOf[e]);
+                }
+            }
+        }
+    }
+
+    vector<int> randomSources(int n, mt19937_64& rng) {
+        vector<int> sources;
+        int k = 1 + (int) (rng() % 4);
+        for (int i = 0; i < k; i++) {
+            sources.push_back((int) (rng() % n));
+        }
+        return sources;
+    }
+
+    /**
+     * Runs a random sequence of changes on the incremental flow of one random graph.
+     */
+    void testRandomGraph(uint64_t seed, int steps) {
+        mt19937_64 rng(seed);
+        Graph g;
+        int n = 4 + (int) (rng() % 30);
+        buildRandomGraph(g, n, rng);
+        CSRGraph network(g);
+
+        vector<pair<int, int>> segments;
+        for (int u = 0; u < n; u++) {
+            for (Edge* e : network.getVertex(u)->getAdj()) {
+                int v = network.indexOf(e->getDest());
+                if (e->getReverse() == nullptr || u < v) segments.emplace_back(u, v);
+            }
+        }
+
+        set<pair<int, int>> removed;
+        map<pair<int, int>, int> capacities;
+        vector<int> sources = randomSources(n, rng);
+        int t = (int) (rng() % n);
+        FlowWorkspace ws, fresh;
+        unsigned long flow = network.startIncrementalFlow(ws, sources, t);
+
+        for (int step = 0; step <= steps; step++) {
+            Graph reduced;
+            copyGraph(g, reduced, removed, capacities);
+            CSRGraph expected(reduced);
+            unsigned long value = expected.maxFlow(fresh, sources, t, FlowEngine::EDMONDS_KARP);
+            check(flow == value, "graph " + to_string(seed) + " step " + to_string(step) + ": repaired flow "
+                                 + to_string(flow) + ", computed " + to_string(value));
+            if (flow != value || segments.empty()) return;
+
+            auto segment = segments[rng() % segments.size()];
+            int a = network.findArc(segment.first, segment.second);
+            auto key = segmentOf(segment.first, segment.second);
+            switch (rng() % 4) {
+                case 0:
+                    if (removed.count(key)) continue;
+                    flow = network.removeSegment(ws, a);
+                    removed.insert(key);
+                    break;
+                case 1:
+                    if (!removed.count(key)) continue;
+                    flow = network.restoreSegment(ws, a);
+                    removed.erase(key);
+                    capacities.erase(key);
+                    break;
+                case 2: {
+                    if (removed.count(key)) continue;
+                    int c = (int) (rng() % 10);
+                    flow = network.setSegmentCapacity(ws, a, c);
+                    capacities[key] = c;
+                    break;
+                }
+                default:
+                    sources = randomSources(n, rng);
+                    flow = network.setIncrementalSources(ws, sources);
+            }
+        }
+    }
+
+    /**
+     * @return The inflow of every station of a network, as computed by the menu and the batch queries
+     */
+    vector<unsigned long> computeInflows(const CSRGraph& network) {
+        FlowWorkspace ws;
+        vector<int> sources;
+        vector<unsigned long> inflows(network.getNumVertex());
+        for (int v = 0; v < network.getNumVertex(); v++) {
+            network.findInflowSources(ws, v, sources);
+            inflows[v] = sources.empty() ? 0 : network.maxFlow(ws, sources, v, FlowEngine::EDMONDS_KARP);
+        }
+        return inflows;
+    }
+
+    /**
+     * Evaluates the failure of every segment, and of some sections of lines, on a generated network.
+     */
+    void testGeneratedNetwork(uint64_t seed, ParallelFlowDriver& driver) {
+        NetworkGenerator::Parameters parameters;
+        parameters.stations = 30 + (int) (seed % 40);
+        parameters.lines = 1 + (int) (seed % 3);
+        parameters.branching = 0.4;
+        parameters.express = 0.8;
+        parameters.interchanges = 0.5;
+        parameters.minCapacity = 1;
+        parameters.maxCapacity = 9;
+        parameters.seed = seed;
+        string prefix = filesystem::temp_directory_path().string() + "/incremental-flow-test-" + to_string(seed);
+        if (NetworkGenerator(parameters).write(prefix + "-stations.csv", prefix + "-network.csv") < 0) {
+            check(false, "network " + to_string(seed) + " could not be written");
+            return;
+        }
+        TrainManager manager(prefix + "-stations.csv", prefix + "-network.csv");
+        manager.LoadStations();
+        manager.LoadNetworks();
+        filesystem::remove(prefix + "-stations.csv");
+        filesystem::remove(prefix + "-network.csv");
+        const Graph& g = manager.getNetwork();
+        CSRGraph network(g);
+        int n = network.getNumVertex();
+
+        vector<FailureScenarioEngine::Scenario> scenarios;
+        for (int u = 0; u < n; u++) {
+            for (Edge* e : network.getVertex(u)->getAdj()) {
+                int v = network.indexOf(e->getDest());
+                if (u < v) scenarios.push_back({{u, v}});
+            }
+        }
+        for (int u = 0; u + 3 < n; u += 7) {
+            scenarios.push_back(FailureScenarioEngine::lineSection({u, u + 1, u + 2, u + 3}));
+        }
+        auto impacts = FailureScenarioEngine(network, driver).evaluate(scenarios);
+
+        vector<unsigned long> before = computeInflows(network);
+        for (size_t s = 0; s < scenarios.size(); s++) {
+            set<pair<int, int>> removed;
+            set<int> lines;
+            for (const auto& segment : scenarios[s]) {
+                if (network.findArc(segment.first, segment.second) == -1) continue;
+                removed.insert(segmentOf(segment.first, segment.second));
+                lines.insert(network.getLine(segment.first));
+            }
+            Graph reduced;
+            copyGraph(g, reduced, removed, {});
+            vector<unsigned long> after = computeInflows(CSRGraph(reduced));
+
+            map<int, pair<unsigned long, unsigned long>> expected, found;
+            for (int v = 0; v < n; v++) {
+                if (lines.count(network.getLine(v)) && after[v] != before[v]) expected[v] = {before[v], after[v]};
+            }
+            for (const StationImpact& impact : impacts[s]) {
+                found[impact.station] = {impact.before, impact.after};
+            }
+            for (const auto& e : expected) {
+                auto it = found.find(e.first);
+                check(it != found.end() && it->second == e.second,
+                      "network " + to_string(seed) + " scenario " + to_string(s) + " station " + to_string(e.first)
+                      + ": computed " + to_string(e.second.first) + " -> " + to_string(e.second.second)
+                      + (it == found.end() ? ", not reported" : ", reported " + to_string(it->second.first) + " -> "
+                                                                 + to_string(it->second.second)));
+            }
+            for (const auto& f : found) {
+                check(expected.count(f.first), "network " + to_string(seed) + " scenario " + to_string(s)
+                                               + " station " + to_string(f.first) + ": reported a change of "
+                                               + to_string(f.second.first) + " -> " + to_string(f.second.second)
+                                               + " that does not happen");
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int graphs = 1000, steps = 30, networks = 40;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string option = argv[i];
+        if (option == "--graphs") graphs = stoi(argv[i + 1]);
+        else if (option == "--steps") steps = stoi(argv[i + 1]);
+        else if (option == "--networks") networks = stoi(argv[i + 1]);
+    }
+
+    for (int seed = 1; seed <= graphs; seed++) {
+        testRandomGraph(seed, steps);
+    }
+    ParallelFlowDriver driver;
+    for (int seed = 1; seed <= networks; seed++) {
+        testGeneratedNetwork(seed, driver);
+    }
+    if (failures > 0) {
+        cerr << failures << " checks failed" << endl;
+        return 1;
+    }
+    cout << "incremental flow matches the flow computed from scratch on " << graphs << " graphs and the failure "
+         << "scenarios of " << networks << " networks" << endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "../src/NetworkGenerator.h"
+#include "../src/NetworkSnapshot.h"
+#include "../src/TrainManager.h"
+using namespace std;
+
+/*
+ * Writes a synthetic train network, as stations.csv and network.csv in a directory, and optionally its snapshot:
+ *
+ *   generate [--out DIR] [--stations N] [--lines N] [--branching P] [--express P] [--interchanges P]
+ *            [--capacity MIN:MAX] [--skewed] [--municipality-size N] [--districts N] [--seed N] [--snapshot]
+ *
+ * The same options always give the same files. The directory can be given to bench with --resources.
+ */
+
+namespace {
+    bool parseOptions(int argc, char* argv[], NetworkGenerator::Parameters& p, string& out, bool& snapshot) {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--skewed") {
+                p.skewedCapacity = true;
+                continue;
+            }
+            if (arg == "--snapshot") {
+                snapshot = true;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            string value = argv[++i];
+            try {
+                if (arg == "--out") out = value;
+                else if (arg == "--stations") p.stations = stoi(value);
+                else if (arg == "--lines") p.lines = stoi(value);
+                else if (arg == "--branching") p.branching = stod(value);
+                else if (arg == "--express") p.express = stod(value);
+                else if (arg == "--interchanges") p.interchanges = stod(value);
+                else if (arg == "--municipality-size") p.stationsPerMunicipality = stoi(value);
+                else if (arg == "--districts") p.districts = stoi(value);
+                else if (arg == "--seed") p.seed = stoull(value);
+                else if (arg == "--capacity") {
+                    size_t colon = value.find(':');
+                    if (colon == string::npos) return false;
+                    p.minCapacity = stoi(value.substr(0, colon));
+                    p.maxCapacity = stoi(value.substr(colon + 1));
+                }
+                else return false;
+            }
+            catch (const logic_error&) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    NetworkGenerator::Parameters parameters;
+    string out = ".";
+    bool snapshot = false;
+    if (!parseOptions(argc, argv, parameters, out, snapshot)) {
+        cerr << "Usage: generate [--out DIR] [--stations N] [--lines N] [--branching P] [--express P] "
+                "[--interchanges P] [--capacity MIN:MAX] [--skewed] [--municipality-size N] [--districts N] "
+                "[--seed N] [--snapshot]\n";
+        return 1;
+    }
+    NetworkGenerator generator(parameters);
+    string error = generator.validate();
+    if (!error.empty()) {
+        cerr << "Invalid parameters: " << error << "\n";
+        return 1;
+    }
+
+    error_code ec;
+    filesystem::create_directories(out, ec);
+    string stationsFile = out + "/stations.csv", networkFile = out + "/network.csv";
+    auto start = chrono::steady_clock::now();
+    long segments = generator.write(stationsFile, networkFile);
+    if (segments < 0) {
+        cerr << "Could not write the network to " << out << "!\n";
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Wrote " << parameters.stations << " stations and " << segments << " segments to " << out << " in "
+         << seconds << " s\n";
+
+    if (snapshot) {
+        TrainManager manager(stationsFile, networkFile);
+        manager.LoadStations();
+        manager.LoadNetworks();
+        string snapshotFile = out + "/network.snapshot";
+        if (!NetworkSnapshot::write(snapshotFile, manager.getNetwork(), {stationsFile, networkFile})) {
+            cerr << "Could not write " << snapshotFile << "!\n";
+            return 1;
+        }
+        cout << "Wrote " << snapshotFile << "\n";
+    }
+    return 0;
+}